@@ -1,11 +1,97 @@
 #ifndef DACAL_ALGORITHM_HPP
 #define DACAL_ALGORITHM_HPP
 
+#include "binary_search.hpp"
+#include "execution.hpp"
 #include "iterator.hpp"
+#include "loser_tree.hpp"
+#include "pair.hpp"
+#include "parallel_sort.hpp"
 #include "quick_sort.hpp"
+#include "radix_sort.hpp"
+#include "reduction.hpp"
+#include "selection.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include "tim_sort.hpp"
 #include "utils.hpp"
+#include "vector.hpp"
 
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <type_traits>
+#include <utility>
+
+namespace detail {
+// ranges an element wise copy between may be done with memmove instead:
+// both contiguous and holding the same trivially copyable type
+template<class InIter, class OutIter>
+concept memmove_range = dacal::ContiguousIterator<InIter> &&
+    dacal::ContiguousIterator<OutIter> &&
+    std::is_same_v<std::remove_cv_t<typename InIter::value_type>,
+                   typename OutIter::value_type> &&
+    std::is_trivially_copyable_v<typename OutIter::value_type>;
+
+// whether every byte of value is the same, which lets a fill use memset
+template<class T>
+bool repeated_byte(const T &value, unsigned char &byte)
+{
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (std::size_t i = 1; i < sizeof(T); ++i) {
+        if (bytes[i] != bytes[0])
+            return false;
+    }
+    byte = bytes[0];
+    return true;
+}
+
+// iterator type of the runs kway_merge gets as dacal::pair of iterators
+template<class RangeIter>
+using kway_run_iterator = std::remove_cvref_t<
+    decltype(std::declval<typename RangeIter::value_type>()._first)>;
+
+// copies of the runs kway_merge walks, built in place so the run iterators
+// need no default constructor
+template<class Run>
+class kway_runs
+{
+public:
+    explicit kway_runs(std::size_t capacity) :
+        _data(std::allocator<Run>().allocate(capacity)), _capacity(capacity)
+    {}
+    kway_runs(const kway_runs &other) = delete;
+    ~kway_runs()
+    {
+        for (std::size_t i = 0; i < _size; ++i)
+            _data[i].~Run();
+        std::allocator<Run>().deallocate(_data, _capacity);
+    }
+
+    kway_runs &operator=(const kway_runs &other) = delete;
+
+    void push(const Run &run)
+    {
+        ::new (static_cast<void *>(_data + _size)) Run(run);
+        ++_size;
+    }
+
+    Run &operator[](std::size_t index)
+    {
+        return _data[index];
+    }
+
+private:
+    Run *_data;
+    std::size_t _size{};
+    std::size_t _capacity;
+};
+
+}  // namespace detail
 
 namespace dacal {
 template<class Container>
@@ -43,10 +129,37 @@ for_each(InIter _first, InIter _last, const UnaryFunction &_func)
     }
 }
 
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter,
+    class UnaryFunction>
+[[maybe_unused]] void for_each(
+    const Policy &_policy,
+    RandIter _first,
+    RandIter _last,
+    const UnaryFunction &_func)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        detail::parallel_chunk_count(_policy, _size),
+        [&](std::size_t, std::size_t low, std::size_t high) {
+            for (auto i = low; i < high; ++i)
+                _func(_first[i]);
+        });
+}
+
 template<InputIterator InIter, class T>
 [[maybe_unused]] [[nodiscard]] InIter
 find(InIter _first, InIter _last, const T &_value)
 {
+    if constexpr (detail::simd_range<InIter, T>) {
+        auto _found = detail::simd_find<typename InIter::value_type>(
+            _first._ptr, _last._ptr, _value);
+        return InIter(_first._ptr + (_found - _first._ptr));
+    }
+
     for (; _first != _last; ++_first) {
         if (*_first == _value) {
             return _first;
@@ -67,10 +180,58 @@ find_if(InIter _first, InIter _last, const UnaryPredicate &_predicate)
     return _last;
 }
 
+// the first match, as in the serial find_if; chunks past a match already
+// found stop early
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter,
+    class UnaryPredicate>
+[[maybe_unused]] [[nodiscard]] RandIter find_if(
+    const Policy &_policy,
+    RandIter _first,
+    RandIter _last,
+    const UnaryPredicate &_predicate)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    std::atomic<std::size_t> _found{_size};
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        detail::parallel_chunk_count(_policy, _size),
+        [&](std::size_t, std::size_t low, std::size_t high) {
+            for (; low < high; low += detail::parallel_cancel_block) {
+                if (_found.load(std::memory_order_relaxed) < low)
+                    return;
+
+                auto block_high = high - low > detail::parallel_cancel_block
+                    ? low + detail::parallel_cancel_block
+                    : high;
+                for (auto i = low; i < block_high; ++i) {
+                    if (!_predicate(_first[i]))
+                        continue;
+
+                    auto found = _found.load(std::memory_order_relaxed);
+                    while (i < found &&
+                           !_found.compare_exchange_weak(
+                               found, i, std::memory_order_relaxed))
+                        ;
+                    return;
+                }
+            }
+        });
+    return _first + static_cast<int>(_found.load());
+}
+
 template<InputIterator InIter, class T>
 [[maybe_unused]] typename InIter::difference_type
 count(InIter _first, InIter _last, const T &_value)
 {
+    if constexpr (detail::simd_range<InIter, T>) {
+        return static_cast<typename InIter::difference_type>(
+            detail::simd_count<typename InIter::value_type>(
+                _first._ptr, _last._ptr, _value));
+    }
+
     typename InIter::difference_type _ret = 0;
     for (; _first != _last; ++_first) {
         if (*_first == _value)
@@ -83,6 +244,11 @@ template<InputIterator InIter, class UnaryPredicate>
 [[maybe_unused]] typename InIter::difference_type
 count_if(InIter _first, InIter _last, const UnaryPredicate &_predicate)
 {
+    if constexpr (detail::simd_predicate_range<InIter, UnaryPredicate>) {
+        return static_cast<typename InIter::difference_type>(
+            detail::simd_count_if(_first._ptr, _last._ptr, _predicate));
+    }
+
     typename InIter::difference_type _ret = 0;
     for (; _first != _last; ++_first) {
         if (_predicate(*_first))
@@ -91,13 +257,92 @@ count_if(InIter _first, InIter _last, const UnaryPredicate &_predicate)
     return _ret;
 }
 
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter,
+    class UnaryPredicate>
+[[maybe_unused]] typename RandIter::difference_type count_if(
+    const Policy &_policy,
+    RandIter _first,
+    RandIter _last,
+    const UnaryPredicate &_predicate)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    auto _chunks = detail::parallel_chunk_count(_policy, _size);
+    std::unique_ptr<std::size_t[]> _counts(new std::size_t[_chunks]);
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        _chunks,
+        [&](std::size_t chunk, std::size_t low, std::size_t high) {
+            _counts[chunk] = static_cast<std::size_t>(dacal::count_if(
+                _first + static_cast<int>(low),
+                _first + static_cast<int>(high),
+                _predicate));
+        });
+
+    typename RandIter::difference_type _ret = 0;
+    for (std::size_t _i = 0; _i < _chunks; ++_i)
+        _ret += static_cast<typename RandIter::difference_type>(_counts[_i]);
+    return _ret;
+}
+
 template<InputIterator InIter, class UnaryPredicate>
 [[maybe_unused]] bool
 any_off(InIter _first, InIter _last, const UnaryPredicate &_predicate)
 {
+    if constexpr (detail::simd_predicate_range<InIter, UnaryPredicate>) {
+        return detail::simd_any_of(
+            static_cast<const typename InIter::value_type *>(_first._ptr),
+            _last._ptr,
+            _predicate);
+    }
+
     return dacal::find_if(_first, _last, _predicate) != _last;
 }
 
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter,
+    class UnaryPredicate>
+[[maybe_unused]] bool any_off(
+    const Policy &_policy,
+    RandIter _first,
+    RandIter _last,
+    const UnaryPredicate &_predicate)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    std::atomic<bool> _found{false};
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        detail::parallel_chunk_count(_policy, _size),
+        [&](std::size_t, std::size_t low, std::size_t high) {
+            for (; low < high; low += detail::parallel_cancel_block) {
+                if (_found.load(std::memory_order_relaxed))
+                    return;
+
+                auto block_high = high - low > detail::parallel_cancel_block
+                    ? low + detail::parallel_cancel_block
+                    : high;
+                if (dacal::any_off(
+                        _first + static_cast<int>(low),
+                        _first + static_cast<int>(block_high),
+                        _predicate)) {
+                    _found.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+    return _found.load();
+}
+
+template<InputIterator InIter, class T>
+[[maybe_unused]] bool contains(InIter _first, InIter _last, const T &_value)
+{
+    return dacal::find(_first, _last, _value) != _last;
+}
+
 template<InputIterator InIter, class T, class BinaryOperation = dacal::plus<T>>
 [[maybe_unused]] T accumulate(
     InIter _first,
@@ -105,12 +350,226 @@ template<InputIterator InIter, class T, class BinaryOperation = dacal::plus<T>>
     T _init,
     const BinaryOperation &_op = dacal::plus<T>())
 {
+    if constexpr (detail::reduction_range<InIter, T, BinaryOperation>) {
+        return detail::simd_reduce<T>(_first._ptr, _last._ptr, _init, _op);
+    }
+
     for (; _first != _last; ++_first) {
         _init = _op(dacal::move(_init), dacal::move(*_first));
     }
     return _init;
 }
 
+/*
+ *  Every chunk is reduced on its own and the chunk results are combined as
+ *  a tree, neighbours first. The operation has to be associative; unlike
+ *  the serial accumulate, floating point sums are regrouped at the chunk
+ *  boundaries. The sequenced policy keeps the serial order.
+ **/
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter,
+    class T,
+    class BinaryOperation = dacal::plus<T>>
+[[maybe_unused]] T accumulate(
+    const Policy &_policy,
+    RandIter _first,
+    RandIter _last,
+    T _init,
+    const BinaryOperation &_op = dacal::plus<T>())
+{
+    if constexpr (std::is_same_v<Policy, execution::sequenced_policy>) {
+        return dacal::accumulate(_first, _last, dacal::move(_init), _op);
+    }
+
+    auto _size = static_cast<std::size_t>(_last - _first);
+    if (_size == 0)
+        return _init;
+
+    auto _chunks = detail::parallel_chunk_count(_policy, _size);
+    std::unique_ptr<T[]> _partial(new T[_chunks]);
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        _chunks,
+        [&](std::size_t chunk, std::size_t low, std::size_t high) {
+            _partial[chunk] = dacal::accumulate(
+                _first + static_cast<int>(low + 1),
+                _first + static_cast<int>(high),
+                static_cast<T>(_first[low]),
+                _op);
+        });
+
+    for (std::size_t _width = 1; _width < _chunks; _width *= 2) {
+        for (std::size_t _i = 0; _i + _width < _chunks; _i += 2 * _width) {
+            _partial[_i] = _op(
+                dacal::move(_partial[_i]), dacal::move(_partial[_i + _width]));
+        }
+    }
+    return _op(dacal::move(_init), dacal::move(_partial[0]));
+}
+
+// sums in pairs, the rounding error grows with log n rather than n
+template<RandomAccessIterator RandIter, std::floating_point T>
+[[maybe_unused]] T pairwise_sum(RandIter _first, RandIter _last, T _init)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    if constexpr (
+        dacal::ContiguousIterator<RandIter> &&
+        std::is_same_v<typename RandIter::value_type, T>) {
+        return detail::pairwise_sum<T>(
+            static_cast<const T *>(_first._ptr), _size, _init);
+    }
+
+    return detail::pairwise_sum<T>(_first, _size, _init);
+}
+
+// compensated summation, the rounding error does not grow with the length
+template<InputIterator InIter, std::floating_point T>
+[[maybe_unused]] T kahan_sum(InIter _first, InIter _last, T _init)
+{
+    if constexpr (
+        dacal::ContiguousIterator<InIter> &&
+        std::is_same_v<typename InIter::value_type, T> &&
+        detail::simd_element<T>) {
+        return detail::simd_kahan_sum<T>(_first._ptr, _last._ptr, _init);
+    }
+
+    T _compensation{};
+    for (; _first != _last; ++_first) {
+        detail::neumaier_add(_init, _compensation, static_cast<T>(*_first));
+    }
+    return _init + _compensation;
+}
+
+template<
+    InputIterator InIter1,
+    InputIterator InIter2,
+    class T,
+    class BinaryOperation1 = dacal::plus<T>,
+    class BinaryOperation2 = dacal::multiplies<T>>
+[[maybe_unused]] T inner_product(
+    InIter1 _first1,
+    InIter1 _last1,
+    InIter2 _first2,
+    T _init,
+    const BinaryOperation1 &_op1 = BinaryOperation1(),
+    const BinaryOperation2 &_op2 = BinaryOperation2())
+{
+    if constexpr (
+        detail::reduction_range<InIter1, T, BinaryOperation1> &&
+        detail::reduction_range<InIter2, T, BinaryOperation1> &&
+        std::is_same_v<BinaryOperation1, dacal::plus<T>> &&
+        std::is_same_v<BinaryOperation2, dacal::multiplies<T>>) {
+        return detail::simd_inner_product<T>(
+            _first1._ptr, _last1._ptr, _first2._ptr, _init);
+    }
+
+    for (; _first1 != _last1; ++_first1, ++_first2) {
+        _init = _op1(dacal::move(_init), _op2(*_first1, *_first2));
+    }
+    return _init;
+}
+
+template<
+    InputIterator InIter,
+    class Compare = dacal::less<typename InIter::value_type>>
+[[maybe_unused]] [[nodiscard]] InIter
+min_element(InIter _first, InIter _last, const Compare &_compare = Compare())
+{
+    using value_type = typename InIter::value_type;
+
+    if (!(_first != _last))
+        return _last;
+    if constexpr (
+        detail::reduction_range<InIter, value_type, dacal::minimum<value_type>>
+        && std::is_same_v<Compare, dacal::less<value_type>>) {
+        auto _smallest = detail::simd_reduce<value_type>(
+            _first._ptr + 1, _last._ptr, *_first, dacal::minimum<value_type>());
+        return dacal::find(_first, _last, _smallest);
+    }
+
+    auto _smallest = _first;
+    for (++_first; _first != _last; ++_first) {
+        if (_compare(*_first, *_smallest))
+            _smallest = _first;
+    }
+    return _smallest;
+}
+
+template<
+    InputIterator InIter,
+    class Compare = dacal::less<typename InIter::value_type>>
+[[maybe_unused]] [[nodiscard]] InIter
+max_element(InIter _first, InIter _last, const Compare &_compare = Compare())
+{
+    using value_type = typename InIter::value_type;
+
+    if (!(_first != _last))
+        return _last;
+    if constexpr (
+        detail::reduction_range<InIter, value_type, dacal::maximum<value_type>>
+        && std::is_same_v<Compare, dacal::less<value_type>>) {
+        auto _largest = detail::simd_reduce<value_type>(
+            _first._ptr + 1, _last._ptr, *_first, dacal::maximum<value_type>());
+        return dacal::find(_first, _last, _largest);
+    }
+
+    auto _largest = _first;
+    for (++_first; _first != _last; ++_first) {
+        if (_compare(*_largest, *_first))
+            _largest = _first;
+    }
+    return _largest;
+}
+
+// the first smallest and the last largest element
+template<
+    InputIterator InIter,
+    class Compare = dacal::less<typename InIter::value_type>>
+[[maybe_unused]] [[nodiscard]] dacal::pair<InIter, InIter>
+minmax_element(InIter _first, InIter _last, const Compare &_compare = Compare())
+{
+    using value_type = typename InIter::value_type;
+
+    if (!(_first != _last))
+        return dacal::pair<InIter, InIter>(_last, _last);
+    if constexpr (
+        detail::reduction_range<InIter, value_type, dacal::minimum<value_type>>
+        && std::is_same_v<Compare, dacal::less<value_type>>) {
+        value_type _smallest, _largest;
+        detail::simd_minmax<value_type>(
+            _first._ptr, _last._ptr, _smallest, _largest);
+
+        auto _ptr = _last._ptr;
+        while (!(*--_ptr == _largest))
+            ;
+        return dacal::pair<InIter, InIter>(
+            dacal::find(_first, _last, _smallest), InIter(_ptr));
+    }
+
+    auto _smallest = _first, _largest = _first;
+    for (++_first; _first != _last; ++_first) {
+        if (_compare(*_first, *_smallest))
+            _smallest = _first;
+        if (!_compare(*_first, *_largest))
+            _largest = _first;
+    }
+    return dacal::pair<InIter, InIter>(_smallest, _largest);
+}
+
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void sort(
+    RandIter _first,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    detail::quick_sort(
+        _first, static_cast<std::size_t>(_last - _first), _compare);
+}
+
 template<
     RandomAccessIterator RandIter,
     class Compare = dacal::less<typename RandIter::value_type>>
@@ -119,7 +578,255 @@ template<
     RandIter _last,
     const Compare &_compare = dacal::less<typename RandIter::value_type>{})
 {
-    detail::qsort_helper(_first, 0, (_last - _first) - 1, _compare);
+    dacal::sort(_first, _last, _compare);
+}
+
+// puts the element that belongs at _nth in sorted order there, with nothing
+// greater before it and nothing less after it
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void nth_element(
+    RandIter _first,
+    RandIter _nth,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    auto _index = static_cast<std::size_t>(_nth - _first);
+    if (_index >= _size)
+        return;
+
+    detail::introselect(_first, 0, _size, _index, _compare);
+}
+
+// sorts the smallest _middle - _first elements into [_first, _middle), the
+// rest are left in unspecified order
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void partial_sort(
+    RandIter _first,
+    RandIter _middle,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    detail::partial_sort(
+        _first,
+        static_cast<std::size_t>(_middle - _first),
+        static_cast<std::size_t>(_last - _first),
+        _compare);
+}
+
+// the smallest elements of a single pass input, sorted into the output
+// range as far as it reaches; returns the end of what was written
+template<
+    InputIterator InIter,
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] RandIter partial_sort_copy(
+    InIter _first,
+    InIter _last,
+    RandIter _d_first,
+    RandIter _d_last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    auto _capacity = static_cast<std::size_t>(_d_last - _d_first);
+    std::size_t _size = 0;
+    for (; _first != _last && _size < _capacity; ++_first, ++_size)
+        _d_first[_size] = *_first;
+    if (_size == 0)
+        return _d_first;
+
+    detail::make_heap(_d_first, 0, _size, _compare);
+    for (; _first != _last; ++_first) {
+        if (_compare(*_first, _d_first[0])) {
+            _d_first[0] = *_first;
+            detail::sift_down(_d_first, 0, 0, _size, _compare);
+        }
+    }
+    detail::sort_heap(_d_first, 0, _size, _compare);
+    return _d_first + static_cast<int>(_size);
+}
+
+/*
+ *  The _k elements that come first under _compare, by default the largest,
+ *  in that order. Reads the input once holding only a heap of _k elements,
+ *  so lists and single pass sources work too.
+ **/
+template<
+    InputIterator InIter,
+    class Compare = dacal::greater<typename InIter::value_type>>
+[[maybe_unused]] [[nodiscard]] vector<typename InIter::value_type> top_k(
+    InIter _first,
+    InIter _last,
+    std::size_t _k,
+    const Compare &_compare = dacal::greater<typename InIter::value_type>{})
+{
+    vector<typename InIter::value_type> _result;
+    if (_k == 0)
+        return _result;
+
+    for (; _first != _last && _result.size() < _k; ++_first)
+        _result.push_back(*_first);
+    if (_result.size() < _k) {
+        detail::quick_sort(_result.begin(), _result.size(), _compare);
+        return _result;
+    }
+
+    auto _heap = _result.begin();
+    detail::make_heap(_heap, 0, _k, _compare);
+    for (; _first != _last; ++_first) {
+        if (_compare(*_first, _heap[0])) {
+            _heap[0] = *_first;
+            detail::sift_down(_heap, 0, 0, _k, _compare);
+        }
+    }
+    detail::sort_heap(_heap, 0, _k, _compare);
+    return _result;
+}
+
+/*
+ *  Timsort: stable, and linear on input that is already sorted or made of
+ *  a few sorted runs. Scratch memory of up to half the range comes from
+ *  _buffer, which can be kept and reused across calls.
+ **/
+template<
+    RandomAccessIterator RandIter,
+    class Allocator,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void stable_sort(
+    RandIter _first,
+    RandIter _last,
+    stable_sort_buffer<typename RandIter::value_type, Allocator> &_buffer,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    detail::tim_sort(
+        _first, static_cast<std::size_t>(_last - _first), _buffer, _compare);
+}
+
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void stable_sort(
+    RandIter _first,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{})
+{
+    stable_sort_buffer<typename RandIter::value_type> _buffer;
+    dacal::stable_sort(_first, _last, _buffer, _compare);
+}
+
+/*
+ *  Sample sort on a thread pool, falls back to dacal::sort when the input
+ *  is too small to be worth splitting.
+ **/
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void parallel_sort(
+    RandIter _first,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{},
+    thread_pool &_pool = default_thread_pool())
+{
+    detail::sample_sort(
+        _first,
+        static_cast<std::size_t>(_last - _first),
+        _compare,
+        false,
+        _pool);
+}
+
+// parallel_sort that keeps equal elements in their input order
+template<
+    RandomAccessIterator RandIter,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] void parallel_stable_sort(
+    RandIter _first,
+    RandIter _last,
+    const Compare &_compare = dacal::less<typename RandIter::value_type>{},
+    thread_pool &_pool = default_thread_pool())
+{
+    detail::sample_sort(
+        _first,
+        static_cast<std::size_t>(_last - _first),
+        _compare,
+        true,
+        _pool);
+}
+
+/*
+ *  Stable sort by an integer, float or double key, key_fn(element) by
+ *  default the element itself. Runs in O(n * key bytes) with one extra
+ *  buffer of n elements; negative zero sorts before zero and NaNs go to
+ *  the ends by sign.
+ **/
+template<
+    RandomAccessIterator RandIter,
+    class KeyFunction = detail::radix_identity>
+    requires detail::radix_key_type<std::remove_cvref_t<std::invoke_result_t<
+        const KeyFunction &,
+        typename RandIter::reference>>>
+[[maybe_unused]] void radix_sort(
+    RandIter _first, RandIter _last, const KeyFunction &_key_fn = {})
+{
+    detail::radix_sort(
+        _first, static_cast<std::size_t>(_last - _first), _key_fn);
+}
+
+// the first element of the sorted range not ordered before _value
+template<
+    RandomAccessIterator RandIter,
+    class T,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] [[nodiscard]] RandIter lower_bound(
+    RandIter _first,
+    RandIter _last,
+    const T &_value,
+    const Compare &_compare = Compare())
+{
+    auto _index = detail::partition_point(
+        _first,
+        static_cast<std::size_t>(_last - _first),
+        [&_value, &_compare](const auto &element) {
+            return _compare(element, _value);
+        });
+    return _first + static_cast<int>(_index);
+}
+
+// the first element of the sorted range _value is ordered before
+template<
+    RandomAccessIterator RandIter,
+    class T,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] [[nodiscard]] RandIter upper_bound(
+    RandIter _first,
+    RandIter _last,
+    const T &_value,
+    const Compare &_compare = Compare())
+{
+    auto _index = detail::partition_point(
+        _first,
+        static_cast<std::size_t>(_last - _first),
+        [&_value, &_compare](const auto &element) {
+            return !_compare(_value, element);
+        });
+    return _first + static_cast<int>(_index);
+}
+
+template<
+    RandomAccessIterator RandIter,
+    class T,
+    class Compare = dacal::less<typename RandIter::value_type>>
+[[maybe_unused]] [[nodiscard]] bool binary_search(
+    RandIter _first,
+    RandIter _last,
+    const T &_value,
+    const Compare &_compare = Compare())
+{
+    auto _found = dacal::lower_bound(_first, _last, _value, _compare);
+    return _found != _last && !_compare(_value, *_found);
 }
 
 template<InputIterator InIter>
@@ -127,9 +834,9 @@ template<InputIterator InIter>
 distance(InIter _first, InIter _last)
 {
     typename InIter::difference_type _result = 0;
-    if constexpr (std::is_same_v<
-                      random_access_iterator_tag,
-                      typename InIter::iterator_category>) {
+    if constexpr (std::derived_from<
+                      typename InIter::iterator_category,
+                      random_access_iterator_tag>) {
         return _last - _first;
     }
     else {
@@ -142,12 +849,119 @@ distance(InIter _first, InIter _last)
 template<InputIterator InIter, OutputIterator OutIter>
 [[maybe_unused]] OutIter copy(InIter _first, InIter _last, OutIter _d_first)
 {
+    if constexpr (detail::memmove_range<InIter, OutIter>) {
+        auto _size = static_cast<std::size_t>(_last._ptr - _first._ptr);
+        if (_size != 0) {
+            std::memmove(
+                _d_first._ptr, _first._ptr, _size * sizeof(*_first._ptr));
+        }
+        return OutIter(_d_first._ptr + _size);
+    }
+
     for (; _first != _last; ++_first, ++_d_first) {
         *_d_first = *_first;
     }
     return _d_first;
 }
 
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter1,
+    RandomAccessIterator RandIter2>
+[[maybe_unused]] RandIter2 copy(
+    const Policy &_policy,
+    RandIter1 _first,
+    RandIter1 _last,
+    RandIter2 _d_first)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        detail::parallel_chunk_count(_policy, _size),
+        [&](std::size_t, std::size_t low, std::size_t high) {
+            dacal::copy(
+                _first + static_cast<int>(low),
+                _first + static_cast<int>(high),
+                _d_first + static_cast<int>(low));
+        });
+    return _d_first + static_cast<int>(_size);
+}
+
+// copies from the back, so the ranges may overlap with _d_last inside
+// (_first, _last]; returns the start of the copy
+template<BidirectionalIterator BidirIter1, BidirectionalIterator BidirIter2>
+[[maybe_unused]] BidirIter2
+copy_backward(BidirIter1 _first, BidirIter1 _last, BidirIter2 _d_last)
+{
+    if constexpr (detail::memmove_range<BidirIter1, BidirIter2>) {
+        auto _size = static_cast<std::size_t>(_last._ptr - _first._ptr);
+        auto _d_first = _d_last._ptr - _size;
+        if (_size != 0)
+            std::memmove(_d_first, _first._ptr, _size * sizeof(*_first._ptr));
+        return BidirIter2(_d_first);
+    }
+
+    while (_first != _last) {
+        --_last;
+        --_d_last;
+        *_d_last = *_last;
+    }
+    return _d_last;
+}
+
+template<InputIterator InIter, OutputIterator OutIter>
+[[maybe_unused]] OutIter move(InIter _first, InIter _last, OutIter _d_first)
+{
+    if constexpr (detail::memmove_range<InIter, OutIter>) {
+        return dacal::copy(_first, _last, _d_first);
+    }
+
+    for (; _first != _last; ++_first, ++_d_first) {
+        *_d_first = dacal::move(*_first);
+    }
+    return _d_first;
+}
+
+template<ForwardIterator FwdIter, class T>
+[[maybe_unused]] void fill(FwdIter _first, FwdIter _last, const T &_value)
+{
+    using value_type = typename FwdIter::value_type;
+
+    if constexpr (
+        ContiguousIterator<FwdIter> &&
+        std::is_trivially_copyable_v<value_type>) {
+        auto _converted = static_cast<value_type>(_value);
+        unsigned char _byte;
+        if (detail::repeated_byte(_converted, _byte)) {
+            auto _size = static_cast<std::size_t>(_last._ptr - _first._ptr);
+            if (_size != 0)
+                std::memset(_first._ptr, _byte, _size * sizeof(value_type));
+            return;
+        }
+    }
+
+    for (; _first != _last; ++_first) {
+        *_first = _value;
+    }
+}
+
+// copy constructs into raw storage starting at _d_first
+template<InputIterator InIter, ForwardIterator FwdIter>
+[[maybe_unused]] FwdIter
+uninitialized_copy(InIter _first, InIter _last, FwdIter _d_first)
+{
+    if constexpr (detail::memmove_range<InIter, FwdIter>) {
+        return dacal::copy(_first, _last, _d_first);
+    }
+
+    for (; _first != _last; ++_first, ++_d_first) {
+        ::new (static_cast<void *>(&*_d_first))
+            typename FwdIter::value_type(*_first);
+    }
+    return _d_first;
+}
+
 template<InputIterator InIter, OutputIterator OutIter, class UnaryFunction>
 [[maybe_unused]] OutIter transform(
     InIter _first, InIter _last, OutIter _d_first, const UnaryFunction &_func)
@@ -158,6 +972,30 @@ template<InputIterator InIter, OutputIterator OutIter, class UnaryFunction>
     return _d_first;
 }
 
+template<
+    ExecutionPolicy Policy,
+    RandomAccessIterator RandIter1,
+    RandomAccessIterator RandIter2,
+    class UnaryFunction>
+[[maybe_unused]] RandIter2 transform(
+    const Policy &_policy,
+    RandIter1 _first,
+    RandIter1 _last,
+    RandIter2 _d_first,
+    const UnaryFunction &_func)
+{
+    auto _size = static_cast<std::size_t>(_last - _first);
+    detail::parallel_for_chunks(
+        _policy,
+        _size,
+        detail::parallel_chunk_count(_policy, _size),
+        [&](std::size_t, std::size_t low, std::size_t high) {
+            for (auto i = low; i < high; ++i)
+                _d_first[i] = _func(_first[i]);
+        });
+    return _d_first + static_cast<int>(_size);
+}
+
 template<InputIterator InIter1, InputIterator InIter2, OutputIterator OutIter>
 [[maybe_unused]] OutIter merge(
     InIter1 _first1,
@@ -182,6 +1020,59 @@ template<InputIterator InIter1, InputIterator InIter2, OutputIterator OutIter>
     return dacal::copy(_first2, _last2, _d_first);
 }
 
+/*
+ *  Merges any number of sorted runs, given as a range of dacal::pair of
+ *  iterators, with a loser tree: log k comparisons per element instead of
+ *  the k passes of chained two way merges. Equal elements keep the order of
+ *  their runs, so the merge is stable. The range of runs is walked twice,
+ *  once to count them; elements are compared where they are, not copied.
+ **/
+template<
+    ForwardIterator FwdIter,
+    OutputIterator OutIter,
+    class Compare = dacal::less<
+        typename detail::kway_run_iterator<FwdIter>::value_type>>
+[[maybe_unused]] OutIter kway_merge(
+    FwdIter _first,
+    FwdIter _last,
+    OutIter _d_first,
+    const Compare &_compare = Compare())
+{
+    using run_type = std::remove_cvref_t<typename FwdIter::value_type>;
+
+    std::size_t _count = 0;
+    for (auto _run = _first; _run != _last; ++_run)
+        ++_count;
+    if (_count == 0)
+        return _d_first;
+
+    detail::kway_runs<run_type> _runs(_count);
+    for (; _first != _last; ++_first)
+        _runs.push(*_first);
+
+    auto _less = [&_runs, &_compare](std::size_t lhs, std::size_t rhs) {
+        return _compare(*_runs[lhs]._first, *_runs[rhs]._first);
+    };
+    detail::loser_tree<decltype(_less)> _tree(_count, _less);
+    for (std::size_t i = 0; i < _count; ++i) {
+        if (!(_runs[i]._first != _runs[i]._second))
+            _tree.exhaust(i);
+    }
+    _tree.build();
+
+    while (!_tree.empty()) {
+        auto _winner = _tree.winner();
+        auto &_run = _runs[_winner];
+        *_d_first = *_run._first;
+        ++_d_first;
+        ++_run._first;
+        if (!(_run._first != _run._second))
+            _tree.exhaust(_winner);
+        _tree.replay();
+    }
+    return _d_first;
+}
+
 }  // namespace dacal
 
 #endif  // DACAL_ALGORITHM_HPP
@@ -0,0 +1,217 @@
+#ifndef DACAL_ARENA_HPP
+#define DACAL_ARENA_HPP
+
+#include "utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace detail {
+struct arena_chunk
+{
+    arena_chunk *_previous;
+    std::size_t _size;
+};
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Monotonic bump pointer arena. Memory comes from a chain of chunks that
+ *  double in size; individual deallocation is a no-op and everything is
+ *  released at once by reset() or the destructor.
+ **/
+class [[maybe_unused]] arena
+{
+public:
+    [[maybe_unused]] explicit arena(std::size_t _initial_chunk_size = 4096);
+    [[maybe_unused]] arena(const arena &_other) = delete;
+    [[maybe_unused]] arena(arena &&_other) noexcept;
+    [[maybe_unused]] ~arena();
+
+    [[maybe_unused]] arena &operator=(const arena &_other) = delete;
+    [[maybe_unused]] arena &operator=(arena &&_other) noexcept;
+
+    [[maybe_unused]] [[nodiscard]] void *allocate(
+        std::size_t _bytes,
+        std::size_t _alignment = alignof(std::max_align_t));
+    [[maybe_unused]] void
+    deallocate(void *_ptr, std::size_t _bytes) noexcept;
+    [[maybe_unused]] void reset() noexcept;
+
+    [[maybe_unused]] [[nodiscard]] std::size_t bytes_allocated() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t bytes_reserved() const;
+
+private:
+    static constexpr std::size_t _header_size =
+        (sizeof(detail::arena_chunk) + alignof(std::max_align_t) - 1) &
+        ~(alignof(std::max_align_t) - 1);
+
+    [[maybe_unused]] void _grow(std::size_t _min_bytes);
+    [[maybe_unused]] void _release(detail::arena_chunk *_chunk) noexcept;
+
+    detail::arena_chunk *_current{};
+    std::uintptr_t _cursor{};
+    std::uintptr_t _end{};
+    std::size_t _next_chunk_size{};
+    std::size_t _allocated{};
+    std::size_t _reserved{};
+};
+
+[[maybe_unused]] inline arena::arena(std::size_t _initial_chunk_size) :
+    _next_chunk_size(_initial_chunk_size > 64 ? _initial_chunk_size : 64)
+{}
+
+[[maybe_unused]] inline arena::arena(arena &&_other) noexcept :
+    _current(dacal::exchange(_other._current, nullptr)),
+    _cursor(dacal::exchange(_other._cursor, 0)),
+    _end(dacal::exchange(_other._end, 0)),
+    _next_chunk_size(_other._next_chunk_size),
+    _allocated(dacal::exchange(_other._allocated, 0)),
+    _reserved(dacal::exchange(_other._reserved, 0))
+{}
+
+[[maybe_unused]] inline arena::~arena()
+{
+    _release(_current);
+}
+
+[[maybe_unused]] inline arena &arena::operator=(arena &&_other) noexcept
+{
+    if (this != &_other) {
+        _release(_current);
+        _current = dacal::exchange(_other._current, nullptr);
+        _cursor = dacal::exchange(_other._cursor, 0);
+        _end = dacal::exchange(_other._end, 0);
+        _next_chunk_size = _other._next_chunk_size;
+        _allocated = dacal::exchange(_other._allocated, 0);
+        _reserved = dacal::exchange(_other._reserved, 0);
+    }
+    return *this;
+}
+
+[[maybe_unused]] inline void arena::_grow(std::size_t _min_bytes)
+{
+    auto _size = _next_chunk_size;
+    while (_size < _min_bytes)
+        _size *= 2;
+    _next_chunk_size = _size * 2;
+
+    auto _chunk = static_cast<detail::arena_chunk *>(
+        ::operator new(_header_size + _size));
+    _chunk->_previous = _current;
+    _chunk->_size = _size;
+    _current = _chunk;
+    _reserved += _size;
+
+    _cursor = reinterpret_cast<std::uintptr_t>(_chunk) + _header_size;
+    _end = _cursor + _size;
+}
+
+[[maybe_unused]] inline void
+arena::_release(detail::arena_chunk *_chunk) noexcept
+{
+    while (_chunk != nullptr) {
+        auto _previous = _chunk->_previous;
+        ::operator delete(_chunk);
+        _chunk = _previous;
+    }
+}
+
+[[maybe_unused]] [[nodiscard]] inline void *
+arena::allocate(std::size_t _bytes, std::size_t _alignment)
+{
+    auto _aligned = (_cursor + _alignment - 1) & ~(_alignment - 1);
+    if (_current == nullptr || _aligned + _bytes > _end) {
+        _grow(_bytes + _alignment);
+        _aligned = (_cursor + _alignment - 1) & ~(_alignment - 1);
+    }
+
+    _cursor = _aligned + _bytes;
+    _allocated += _bytes;
+    return reinterpret_cast<void *>(_aligned);
+}
+
+[[maybe_unused]] inline void arena::deallocate(
+    [[maybe_unused]] void *_ptr, [[maybe_unused]] std::size_t _bytes) noexcept
+{}
+
+[[maybe_unused]] inline void arena::reset() noexcept
+{
+    if (_current == nullptr)
+        return;
+
+    // keep the newest chunk, it is the largest and a reused arena will
+    // likely need that much again
+    _release(_current->_previous);
+    _current->_previous = nullptr;
+    _reserved = _current->_size;
+    _allocated = 0;
+    _cursor = reinterpret_cast<std::uintptr_t>(_current) + _header_size;
+    _end = _cursor + _current->_size;
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t arena::bytes_allocated() const
+{
+    return _allocated;
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t arena::bytes_reserved() const
+{
+    return _reserved;
+}
+
+template<class T>
+class [[maybe_unused]] arena_allocator
+{
+public:
+    using value_type = T;
+
+    [[maybe_unused]] explicit arena_allocator(arena &_owner) noexcept :
+        _arena(&_owner)
+    {}
+
+    template<class U>
+    [[maybe_unused]] arena_allocator(
+        const arena_allocator<U> &_other) noexcept :
+        _arena(_other._arena)
+    {}
+
+    [[maybe_unused]] [[nodiscard]] T *allocate(std::size_t _n)
+    {
+        return static_cast<T *>(_arena->allocate(_n * sizeof(T), alignof(T)));
+    }
+
+    [[maybe_unused]] void deallocate(T *_ptr, std::size_t _n) noexcept
+    {
+        _arena->deallocate(_ptr, _n * sizeof(T));
+    }
+
+    [[maybe_unused]] [[nodiscard]] arena *resource() const
+    {
+        return _arena;
+    }
+
+    template<class U>
+    [[maybe_unused]] bool operator==(const arena_allocator<U> &_other) const
+    {
+        return _arena == _other._arena;
+    }
+
+    template<class U>
+    [[maybe_unused]] bool operator!=(const arena_allocator<U> &_other) const
+    {
+        return _arena != _other._arena;
+    }
+
+private:
+    template<class U>
+    friend class arena_allocator;
+
+    arena *_arena;
+};
+
+}  // namespace dacal
+
+#endif  // DACAL_ARENA_HPP
@@ -4,46 +4,48 @@
 #include "iterator.hpp"
 
 #include <cstdint>
+#include <cstring>
 #include <initializer_list>
+#include <type_traits>
 
 namespace detail {
 template<class T>
 struct [[maybe_unused]] array_iterator : dacal::base_iterator<
-                                             dacal::random_access_iterator_tag,
+                                             dacal::contiguous_iterator_tag,
                                              T,
                                              std::size_t,
                                              T *,
                                              T &>
 {
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::iterator_category;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::value_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::difference_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::pointer;
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
@@ -133,42 +135,42 @@ struct [[maybe_unused]] array_iterator : dacal::base_iterator<
 template<class T>
 struct [[maybe_unused]] const_array_iterator
     : dacal::base_iterator<
-          dacal::random_access_iterator_tag,
+          dacal::contiguous_iterator_tag,
           T,
           std::size_t,
           T *,
           T &>
 {
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::iterator_category;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::value_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::difference_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::pointer;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
@@ -286,23 +288,26 @@ public:
 
     [[maybe_unused]] [[nodiscard]] std::size_t capacity() const;
     [[maybe_unused]] [[nodiscard]] std::size_t length() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
 
 private:
     std::size_t _size = N;
-    [[maybe_unused]] static std::size_t _len;
+    std::size_t _len{};
     T _buffer[N];
 };
 
-template<typename T, std::size_t N>
-std::size_t array<T, N>::_len = 0;
-
 template<typename T, std::size_t N>
 [[maybe_unused]] array<T, N>::array(const array<T, N> &cp)
 {
     _size = N;
     _len = cp._len;
-    for (auto i = 0; i < _len; i++) {
-        _buffer[i] = cp._buffer[i];
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memcpy(_buffer, cp._buffer, _len * sizeof(T));
+    }
+    else {
+        for (auto i = 0; i < _len; i++) {
+            _buffer[i] = cp._buffer[i];
+        }
     }
 }
 
@@ -413,6 +418,13 @@ template<typename T, std::size_t N>
     return _len;
 }
 
+template<typename T, std::size_t N>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+array<T, N>::memory_usage() const
+{
+    return {_len * sizeof(T), sizeof(*this) - _len * sizeof(T)};
+}
+
 }  // namespace dacal
 
 #endif  // DACAL_ARRAY_HPP
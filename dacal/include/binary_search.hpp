@@ -0,0 +1,57 @@
+#ifndef DACAL_BINARY_SEARCH_HPP
+#define DACAL_BINARY_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace detail {
+// a hint only: addresses outside the data do not fault, so callers may
+// prefetch past the end
+[[maybe_unused]] inline void prefetch(std::uintptr_t address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(reinterpret_cast<const void *>(address));
+#else
+    (void)address;
+#endif
+}
+
+template<class Iterator>
+void prefetch_element(Iterator array, std::size_t index)
+{
+    if constexpr (std::is_lvalue_reference_v<decltype(array[0])>)
+        prefetch(reinterpret_cast<std::uintptr_t>(&array[index]));
+}
+
+/*
+ *  Number of leading elements predicate holds for, on a range it holds for
+ *  a prefix of. Every round halves the range and keeps the base with a
+ *  conditional move rather than a branch, so a round never mispredicts and
+ *  the number of rounds only depends on the size. Both places the next
+ *  round can look at are prefetched, which overlaps the cache misses of
+ *  consecutive rounds on large ranges.
+ **/
+template<class Iterator, class Predicate>
+std::size_t
+partition_point(Iterator array, std::size_t size, const Predicate &predicate)
+{
+    if (size == 0)
+        return 0;
+
+    std::size_t base = 0;
+    while (size > 1) {
+        auto half = size / 2;
+        auto next_half = (size - half) / 2;
+        prefetch_element(array, base + next_half);
+        prefetch_element(array, base + half + next_half);
+
+        base = predicate(array[base + half]) ? base + half : base;
+        size -= half;
+    }
+    return base + static_cast<std::size_t>(predicate(array[base]));
+}
+
+}  // namespace detail
+
+#endif  // DACAL_BINARY_SEARCH_HPP
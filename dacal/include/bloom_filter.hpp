@@ -0,0 +1,353 @@
+#ifndef DACAL_BLOOM_FILTER_HPP
+#define DACAL_BLOOM_FILTER_HPP
+
+#include "iterator.hpp"
+#include "memory_resource.hpp"
+#include "utils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+// one cache line, every key sets and tests bits of a single block only
+struct alignas(64) bloom_block
+{
+    uint64_t _words[8];
+};
+
+}  // namespace detail
+
+namespace dacal {
+template<
+    class T,
+    class Hash = dacal::hash<T>,
+    class Allocator = std::allocator<T>>
+class [[maybe_unused]] bloom_filter
+{
+public:
+    using value_type = T;
+    using const_reference = const T &;
+    using hasher = Hash;
+    using allocator = Allocator;
+    using block_allocator = typename std::allocator_traits<
+        allocator>::template rebind_alloc<detail::bloom_block>;
+
+    [[maybe_unused]] explicit bloom_filter(
+        std::size_t _expected_items,
+        double _false_positive_rate = 0.01,
+        const allocator &_alloc = allocator());
+    [[maybe_unused]] bloom_filter(const bloom_filter &_other);
+    [[maybe_unused]] bloom_filter(bloom_filter &&_other) noexcept;
+    [[maybe_unused]] ~bloom_filter();
+
+    [[maybe_unused]] bloom_filter &operator=(const bloom_filter &_other);
+    [[maybe_unused]] bloom_filter &operator=(bloom_filter &&_other) noexcept;
+
+    [[maybe_unused]] void insert(const_reference _data);
+    template<InputIterator InIter>
+    [[maybe_unused]] void insert(InIter _first, InIter _last);
+
+    [[maybe_unused]] [[nodiscard]] bool contains(const_reference _data) const;
+    template<InputIterator InIter, OutputIterator OutIter>
+    [[maybe_unused]] OutIter
+    contains(InIter _first, InIter _last, OutIter _d_first) const;
+
+    [[maybe_unused]] void clear();
+    [[maybe_unused]] [[nodiscard]] std::size_t block_count() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t hash_count() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+
+    [[maybe_unused]] [[nodiscard]] std::size_t serialized_size() const;
+    [[maybe_unused]] void serialize(uint8_t *_buffer) const;
+    [[maybe_unused]] bool
+    deserialize(const uint8_t *_buffer, std::size_t _size);
+
+private:
+    static constexpr std::size_t _header_size =
+        sizeof(uint64_t) + sizeof(uint64_t);
+
+    [[maybe_unused]] void _allocate(std::size_t _count);
+    [[maybe_unused]] void _destroy();
+    [[maybe_unused]] detail::bloom_block *
+    _locate(const_reference _data, uint64_t (&_mask)[8]) const;
+
+    block_allocator _block_allocator;
+    hasher _hasher;
+    detail::bloom_block *_blocks{};
+    std::size_t _block_count{};
+    std::size_t _hash_count{};
+};
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+bloom_filter<T, Hash, Allocator>::_allocate(std::size_t _count)
+{
+    _block_count = _count;
+    _blocks = std::allocator_traits<block_allocator>::allocate(
+        _block_allocator, _block_count);
+    std::memset(_blocks, 0, _block_count * sizeof(detail::bloom_block));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void bloom_filter<T, Hash, Allocator>::_destroy()
+{
+    if (_blocks)
+        std::allocator_traits<block_allocator>::deallocate(
+            _block_allocator, _blocks, _block_count);
+    _blocks = nullptr;
+    _block_count = 0;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] detail::bloom_block *bloom_filter<T, Hash, Allocator>::_locate(
+    const_reference _data, uint64_t (&_mask)[8]) const
+{
+    auto _hash = detail::hash_mix(_hasher(_data));
+
+    // high half picks the block, low half drives double hashing of the bits
+    auto _block = ((_hash >> 32) * _block_count) >> 32;
+    auto _h1 = static_cast<uint32_t>(_hash);
+    auto _h2 = static_cast<uint32_t>(detail::hash_mix(_hash)) | 1U;
+
+    for (auto &_word : _mask)
+        _word = 0;
+    for (std::size_t i = 0; i < _hash_count; ++i) {
+        auto _bit = (_h1 + static_cast<uint32_t>(i) * _h2) >> 23;
+        _mask[_bit >> 6] |= uint64_t{1} << (_bit & 63);
+    }
+    return _blocks + _block;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator>::bloom_filter(
+    std::size_t _expected_items,
+    double _false_positive_rate,
+    const allocator &_alloc) :
+    _block_allocator(_alloc)
+{
+    if (_expected_items == 0)
+        _expected_items = 1;
+    if (!(_false_positive_rate > 0.0 && _false_positive_rate < 1.0))
+        _false_positive_rate = 0.01;
+
+    // confining a key to one cache line skews the bit load, the extra 20%
+    // of space brings the measured rate back to the requested target
+    auto _ln2 = std::log(2.0);
+    auto _bits_per_item =
+        1.2 * -std::log(_false_positive_rate) / (_ln2 * _ln2);
+    auto _bits = _bits_per_item * static_cast<double>(_expected_items);
+
+    _hash_count = static_cast<std::size_t>(std::lround(_bits_per_item * _ln2));
+    if (_hash_count < 1)
+        _hash_count = 1;
+    if (_hash_count > 16)
+        _hash_count = 16;
+
+    _allocate(static_cast<std::size_t>(std::ceil(_bits / 512.0)));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator>::bloom_filter(
+    const bloom_filter &_other) :
+    _block_allocator(std::allocator_traits<block_allocator>::
+                         select_on_container_copy_construction(
+                             _other._block_allocator)),
+    _hash_count(_other._hash_count)
+{
+    _allocate(_other._block_count);
+    std::memcpy(
+        _blocks, _other._blocks, _block_count * sizeof(detail::bloom_block));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator>::bloom_filter(
+    bloom_filter &&_other) noexcept :
+    _block_allocator(dacal::move(_other._block_allocator))
+{
+    _blocks = dacal::exchange(_other._blocks, nullptr);
+    _block_count = dacal::exchange(_other._block_count, 0);
+    _hash_count = _other._hash_count;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator>::~bloom_filter()
+{
+    _destroy();
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator> &
+bloom_filter<T, Hash, Allocator>::operator=(const bloom_filter &_other)
+{
+    if (this != &_other) {
+        _destroy();
+        _hash_count = _other._hash_count;
+        _allocate(_other._block_count);
+        std::memcpy(
+            _blocks,
+            _other._blocks,
+            _block_count * sizeof(detail::bloom_block));
+    }
+    return *this;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bloom_filter<T, Hash, Allocator> &
+bloom_filter<T, Hash, Allocator>::operator=(bloom_filter &&_other) noexcept
+{
+    if (this != &_other) {
+        _destroy();
+        _block_allocator = _other._block_allocator;
+        _blocks = dacal::exchange(_other._blocks, nullptr);
+        _block_count = dacal::exchange(_other._block_count, 0);
+        _hash_count = _other._hash_count;
+    }
+    return *this;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void bloom_filter<T, Hash, Allocator>::insert(
+    typename bloom_filter<T, Hash, Allocator>::const_reference _data)
+{
+    uint64_t _mask[8];
+    auto _block = _locate(_data, _mask);
+    for (std::size_t i = 0; i < 8; ++i) {
+        _block->_words[i] |= _mask[i];
+    }
+}
+
+template<class T, class Hash, class Allocator>
+template<InputIterator InIter>
+[[maybe_unused]] void
+bloom_filter<T, Hash, Allocator>::insert(InIter _first, InIter _last)
+{
+    for (; _first != _last; ++_first) {
+        insert(*_first);
+    }
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] bool bloom_filter<T, Hash, Allocator>::contains(
+    typename bloom_filter<T, Hash, Allocator>::const_reference _data) const
+{
+    alignas(32) uint64_t _mask[8];
+    auto _block = _locate(_data, _mask);
+
+#if defined(__AVX2__)
+    auto _words = reinterpret_cast<const __m256i *>(_block->_words);
+    auto _bits = reinterpret_cast<const __m256i *>(_mask);
+    auto _missing = _mm256_or_si256(
+        _mm256_andnot_si256(
+            _mm256_load_si256(_words), _mm256_load_si256(_bits)),
+        _mm256_andnot_si256(
+            _mm256_load_si256(_words + 1), _mm256_load_si256(_bits + 1)));
+    return _mm256_testz_si256(_missing, _missing) != 0;
+#else
+    // branch free over the whole line so the compiler can vectorize it
+    uint64_t _missing = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        _missing |= _mask[i] & ~_block->_words[i];
+    }
+    return _missing == 0;
+#endif
+}
+
+template<class T, class Hash, class Allocator>
+template<InputIterator InIter, OutputIterator OutIter>
+[[maybe_unused]] OutIter bloom_filter<T, Hash, Allocator>::contains(
+    InIter _first, InIter _last, OutIter _d_first) const
+{
+    for (; _first != _last; ++_first, ++_d_first) {
+        *_d_first = contains(*_first);
+    }
+    return _d_first;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void bloom_filter<T, Hash, Allocator>::clear()
+{
+    std::memset(_blocks, 0, _block_count * sizeof(detail::bloom_block));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+bloom_filter<T, Hash, Allocator>::block_count() const
+{
+    return _block_count;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+bloom_filter<T, Hash, Allocator>::hash_count() const
+{
+    return _hash_count;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+bloom_filter<T, Hash, Allocator>::serialized_size() const
+{
+    return _header_size + _block_count * sizeof(detail::bloom_block);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+bloom_filter<T, Hash, Allocator>::serialize(uint8_t *_buffer) const
+{
+    // native byte order, the buffer is meant to be read back on the same
+    // architecture
+    uint64_t _header[2] = {_block_count, _hash_count};
+    std::memcpy(_buffer, _header, _header_size);
+    std::memcpy(
+        _buffer + _header_size,
+        _blocks,
+        _block_count * sizeof(detail::bloom_block));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool bloom_filter<T, Hash, Allocator>::deserialize(
+    const uint8_t *_buffer, std::size_t _size)
+{
+    if (_size < _header_size)
+        return false;
+
+    uint64_t _header[2];
+    std::memcpy(_header, _buffer, _header_size);
+    if (_header[0] == 0 || _header[1] < 1 || _header[1] > 16 ||
+        (_size - _header_size) / sizeof(detail::bloom_block) != _header[0] ||
+        (_size - _header_size) % sizeof(detail::bloom_block) != 0)
+        return false;
+
+    _destroy();
+    _hash_count = _header[1];
+    _allocate(_header[0]);
+    std::memcpy(
+        _blocks,
+        _buffer + _header_size,
+        _block_count * sizeof(detail::bloom_block));
+    return true;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename bloom_filter<
+    T, Hash, Allocator>::allocator
+bloom_filter<T, Hash, Allocator>::get_allocator() const
+{
+    return allocator(_block_allocator);
+}
+
+namespace pmr {
+template<class T, class Hash = dacal::hash<T>>
+using bloom_filter = dacal::bloom_filter<T, Hash, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace dacal
+
+#endif  // DACAL_BLOOM_FILTER_HPP
@@ -0,0 +1,212 @@
+#ifndef DACAL_COUNTING_ALLOCATOR_HPP
+#define DACAL_COUNTING_ALLOCATOR_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+namespace dacal {
+/*
+ *  Counters shared by every counting_allocator pointing at them. Updates are
+ *  relaxed atomics, so one instance can be fed from many threads and read
+ *  by a dashboard at any time.
+ **/
+class [[maybe_unused]] allocation_stats
+{
+public:
+    // bucket i counts requests of [2^i, 2^(i + 1)) bytes
+    static constexpr std::size_t histogram_size = 32;
+
+    [[maybe_unused]] void record_allocation(std::size_t _bytes);
+    [[maybe_unused]] void record_deallocation(std::size_t _bytes);
+    [[maybe_unused]] void reset();
+
+    [[maybe_unused]] [[nodiscard]] std::size_t allocations() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t deallocations() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t live_bytes() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t peak_bytes() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t
+    histogram(std::size_t _bucket) const;
+
+private:
+    std::atomic<std::size_t> _allocations{};
+    std::atomic<std::size_t> _deallocations{};
+    std::atomic<std::size_t> _live_bytes{};
+    std::atomic<std::size_t> _peak_bytes{};
+    std::atomic<std::size_t> _histogram[histogram_size]{};
+};
+
+[[maybe_unused]] inline void
+allocation_stats::record_allocation(std::size_t _bytes)
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+
+    auto _bucket = _bytes == 0 ? 0 : std::bit_width(_bytes) - 1;
+    if (_bucket >= histogram_size)
+        _bucket = histogram_size - 1;
+    _histogram[_bucket].fetch_add(1, std::memory_order_relaxed);
+
+    auto _live =
+        _live_bytes.fetch_add(_bytes, std::memory_order_relaxed) + _bytes;
+    auto _peak = _peak_bytes.load(std::memory_order_relaxed);
+    while (_live > _peak &&
+           !_peak_bytes.compare_exchange_weak(
+               _peak, _live, std::memory_order_relaxed)) {
+    }
+}
+
+[[maybe_unused]] inline void
+allocation_stats::record_deallocation(std::size_t _bytes)
+{
+    _deallocations.fetch_add(1, std::memory_order_relaxed);
+    _live_bytes.fetch_sub(_bytes, std::memory_order_relaxed);
+}
+
+[[maybe_unused]] inline void allocation_stats::reset()
+{
+    // live bytes are still live, the peak restarts from them
+    _allocations.store(0, std::memory_order_relaxed);
+    _deallocations.store(0, std::memory_order_relaxed);
+    _peak_bytes.store(
+        _live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (auto &_bucket : _histogram)
+        _bucket.store(0, std::memory_order_relaxed);
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t
+allocation_stats::allocations() const
+{
+    return _allocations.load(std::memory_order_relaxed);
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t
+allocation_stats::deallocations() const
+{
+    return _deallocations.load(std::memory_order_relaxed);
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t
+allocation_stats::live_bytes() const
+{
+    return _live_bytes.load(std::memory_order_relaxed);
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t
+allocation_stats::peak_bytes() const
+{
+    return _peak_bytes.load(std::memory_order_relaxed);
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t
+allocation_stats::histogram(std::size_t _bucket) const
+{
+    return _histogram[_bucket].load(std::memory_order_relaxed);
+}
+
+// counting_allocator instances that were not given their own stats
+[[maybe_unused]] inline allocation_stats &global_allocation_stats()
+{
+    static allocation_stats stats;
+    return stats;
+}
+
+/*
+ *  Forwards to Allocator and records every request in an
+ *  allocation_stats. Rebinding keeps the same stats, so the node
+ *  allocations of a list or map land in the counters of its allocator.
+ **/
+template<class T, class Allocator = std::allocator<T>>
+class [[maybe_unused]] counting_allocator
+{
+public:
+    using value_type = T;
+    using inner_allocator = Allocator;
+
+    template<class U>
+    struct rebind
+    {
+        using other = counting_allocator<
+            U,
+            typename std::allocator_traits<
+                Allocator>::template rebind_alloc<U>>;
+    };
+
+    [[maybe_unused]] counting_allocator() : _stats(&global_allocation_stats())
+    {}
+
+    [[maybe_unused]] explicit counting_allocator(
+        allocation_stats &_counters,
+        const Allocator &_allocator = Allocator()) :
+        _inner(_allocator),
+        _stats(&_counters)
+    {}
+
+    template<class U, class OtherAllocator>
+    [[maybe_unused]] counting_allocator(
+        const counting_allocator<U, OtherAllocator> &_other) :
+        _inner(_other._inner),
+        _stats(_other._stats)
+    {}
+
+    [[maybe_unused]] [[nodiscard]] T *allocate(std::size_t _n)
+    {
+        auto _ptr = std::allocator_traits<Allocator>::allocate(_inner, _n);
+        _stats->record_allocation(_n * sizeof(T));
+        return _ptr;
+    }
+
+    [[maybe_unused]] void deallocate(T *_ptr, std::size_t _n)
+    {
+        // containers release their empty state without checking for null
+        if (_ptr == nullptr)
+            return;
+
+        _stats->record_deallocation(_n * sizeof(T));
+        std::allocator_traits<Allocator>::deallocate(_inner, _ptr, _n);
+    }
+
+    [[maybe_unused]] counting_allocator
+    select_on_container_copy_construction() const
+    {
+        return counting_allocator(
+            *_stats,
+            std::allocator_traits<
+                Allocator>::select_on_container_copy_construction(_inner));
+    }
+
+    [[maybe_unused]] [[nodiscard]] allocation_stats &stats() const
+    {
+        return *_stats;
+    }
+
+    [[maybe_unused]] [[nodiscard]] const Allocator &inner() const
+    {
+        return _inner;
+    }
+
+    template<class U, class OtherAllocator>
+    [[maybe_unused]] bool
+    operator==(const counting_allocator<U, OtherAllocator> &_other) const
+    {
+        return _stats == _other._stats && _inner == _other._inner;
+    }
+
+    template<class U, class OtherAllocator>
+    [[maybe_unused]] bool
+    operator!=(const counting_allocator<U, OtherAllocator> &_other) const
+    {
+        return !(*this == _other);
+    }
+
+private:
+    template<class U, class OtherAllocator>
+    friend class counting_allocator;
+
+    Allocator _inner;
+    allocation_stats *_stats;
+};
+
+}  // namespace dacal
+
+#endif  // DACAL_COUNTING_ALLOCATOR_HPP
@@ -0,0 +1,501 @@
+#ifndef DACAL_CUCKOO_FILTER_HPP
+#define DACAL_CUCKOO_FILTER_HPP
+
+#include "iterator.hpp"
+#include "memory_resource.hpp"
+#include "utils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace detail {
+struct cuckoo_bucket
+{
+    static constexpr std::size_t _slot_count = 4;
+
+    uint16_t _slots[_slot_count];
+};
+
+}  // namespace detail
+
+namespace dacal {
+template<
+    class T,
+    class Hash = dacal::hash<T>,
+    class Allocator = std::allocator<T>>
+class [[maybe_unused]] cuckoo_filter
+{
+public:
+    using value_type = T;
+    using const_reference = const T &;
+    using hasher = Hash;
+    using allocator = Allocator;
+    using bucket_allocator = typename std::allocator_traits<
+        allocator>::template rebind_alloc<detail::cuckoo_bucket>;
+
+    [[maybe_unused]] explicit cuckoo_filter(
+        std::size_t _expected_items,
+        double _false_positive_rate = 0.01,
+        const allocator &_alloc = allocator());
+    [[maybe_unused]] cuckoo_filter(const cuckoo_filter &_other);
+    [[maybe_unused]] cuckoo_filter(cuckoo_filter &&_other) noexcept;
+    [[maybe_unused]] ~cuckoo_filter();
+
+    [[maybe_unused]] cuckoo_filter &operator=(const cuckoo_filter &_other);
+    [[maybe_unused]] cuckoo_filter &operator=(cuckoo_filter &&_other) noexcept;
+
+    [[maybe_unused]] bool insert(const_reference _data);
+    template<InputIterator InIter>
+    [[maybe_unused]] std::size_t insert(InIter _first, InIter _last);
+
+    [[maybe_unused]] [[nodiscard]] bool contains(const_reference _data) const;
+    template<InputIterator InIter, OutputIterator OutIter>
+    [[maybe_unused]] OutIter
+    contains(InIter _first, InIter _last, OutIter _d_first) const;
+
+    [[maybe_unused]] bool erase(const_reference _data);
+
+    [[maybe_unused]] void clear();
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t bucket_count() const;
+    [[maybe_unused]] [[nodiscard]] std::size_t fingerprint_bits() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+
+    [[maybe_unused]] [[nodiscard]] std::size_t serialized_size() const;
+    [[maybe_unused]] void serialize(uint8_t *_buffer) const;
+    [[maybe_unused]] bool
+    deserialize(const uint8_t *_buffer, std::size_t _bytes);
+
+private:
+    static constexpr std::size_t _max_kicks = 500;
+    static constexpr std::size_t _header_size = 5 * sizeof(uint64_t);
+
+    [[maybe_unused]] void _allocate(std::size_t _count);
+    [[maybe_unused]] void _destroy();
+    [[maybe_unused]] void _copy(const cuckoo_filter &_other);
+    [[maybe_unused]] void _move(cuckoo_filter &_other);
+    [[maybe_unused]] std::size_t _alternate(std::size_t _index, uint16_t _fp)
+        const;
+    [[maybe_unused]] bool _add(std::size_t _index, uint16_t _fp);
+    [[maybe_unused]] bool _has(std::size_t _index, uint16_t _fp) const;
+    [[maybe_unused]] bool _remove(std::size_t _index, uint16_t _fp);
+    [[maybe_unused]] void
+    _locate(const_reference _data, std::size_t &_index, uint16_t &_fp) const;
+
+    bucket_allocator _bucket_allocator;
+    hasher _hasher;
+    detail::cuckoo_bucket *_buckets{};
+    std::size_t _bucket_count{};
+    std::size_t _fingerprint_bits{};
+    std::size_t _size{};
+    uint64_t _random_state{0x9e3779b97f4a7c15ULL};
+
+    // a fingerprint evicted by the last failed insertion, the filter is
+    // full while it is occupied
+    bool _has_victim{};
+    std::size_t _victim_index{};
+    uint16_t _victim_fp{};
+};
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+cuckoo_filter<T, Hash, Allocator>::_allocate(std::size_t _count)
+{
+    _bucket_count = _count;
+    _buckets = std::allocator_traits<bucket_allocator>::allocate(
+        _bucket_allocator, _bucket_count);
+    std::memset(_buckets, 0, _bucket_count * sizeof(detail::cuckoo_bucket));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void cuckoo_filter<T, Hash, Allocator>::_destroy()
+{
+    if (_buckets)
+        std::allocator_traits<bucket_allocator>::deallocate(
+            _bucket_allocator, _buckets, _bucket_count);
+    _buckets = nullptr;
+    _bucket_count = 0;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+cuckoo_filter<T, Hash, Allocator>::_copy(const cuckoo_filter &_other)
+{
+    _allocate(_other._bucket_count);
+    std::memcpy(
+        _buckets,
+        _other._buckets,
+        _bucket_count * sizeof(detail::cuckoo_bucket));
+    _fingerprint_bits = _other._fingerprint_bits;
+    _size = _other._size;
+    _random_state = _other._random_state;
+    _has_victim = _other._has_victim;
+    _victim_index = _other._victim_index;
+    _victim_fp = _other._victim_fp;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+cuckoo_filter<T, Hash, Allocator>::_move(cuckoo_filter &_other)
+{
+    _buckets = dacal::exchange(_other._buckets, nullptr);
+    _bucket_count = dacal::exchange(_other._bucket_count, 0);
+    _fingerprint_bits = _other._fingerprint_bits;
+    _size = dacal::exchange(_other._size, 0);
+    _random_state = _other._random_state;
+    _has_victim = dacal::exchange(_other._has_victim, false);
+    _victim_index = _other._victim_index;
+    _victim_fp = _other._victim_fp;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] std::size_t cuckoo_filter<T, Hash, Allocator>::_alternate(
+    std::size_t _index, uint16_t _fp) const
+{
+    // xor keeps the mapping an involution, both buckets can be recovered
+    // from either one and the fingerprint
+    return (_index ^ detail::hash_mix(_fp)) & (_bucket_count - 1);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool
+cuckoo_filter<T, Hash, Allocator>::_add(std::size_t _index, uint16_t _fp)
+{
+    for (auto &_slot : _buckets[_index]._slots) {
+        if (_slot == 0) {
+            _slot = _fp;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool
+cuckoo_filter<T, Hash, Allocator>::_has(std::size_t _index, uint16_t _fp) const
+{
+    auto &_slots = _buckets[_index]._slots;
+    return (_slots[0] == _fp) | (_slots[1] == _fp) | (_slots[2] == _fp) |
+        (_slots[3] == _fp);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool
+cuckoo_filter<T, Hash, Allocator>::_remove(std::size_t _index, uint16_t _fp)
+{
+    for (auto &_slot : _buckets[_index]._slots) {
+        if (_slot == _fp) {
+            _slot = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void cuckoo_filter<T, Hash, Allocator>::_locate(
+    const_reference _data, std::size_t &_index, uint16_t &_fp) const
+{
+    auto _hash = detail::hash_mix(_hasher(_data));
+    _index = _hash & (_bucket_count - 1);
+    _fp = static_cast<uint16_t>(
+        (_hash >> 32) & ((uint64_t{1} << _fingerprint_bits) - 1));
+
+    // zero marks an empty slot
+    if (_fp == 0)
+        _fp = 1;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator>::cuckoo_filter(
+    std::size_t _expected_items,
+    double _false_positive_rate,
+    const allocator &_alloc) :
+    _bucket_allocator(_alloc)
+{
+    if (_expected_items == 0)
+        _expected_items = 1;
+    if (!(_false_positive_rate > 0.0 && _false_positive_rate < 1.0))
+        _false_positive_rate = 0.01;
+
+    // a lookup compares against 2 * 4 fingerprints
+    auto _bits = std::ceil(std::log2(
+        2.0 * detail::cuckoo_bucket::_slot_count / _false_positive_rate));
+    _fingerprint_bits = static_cast<std::size_t>(_bits);
+    if (_fingerprint_bits < 4)
+        _fingerprint_bits = 4;
+    if (_fingerprint_bits > 16)
+        _fingerprint_bits = 16;
+
+    // the table size must be a power of two for the xor alternate to stay in
+    // range, 95% is the load a 4-way table reliably reaches
+    auto _needed = static_cast<std::size_t>(std::ceil(
+        static_cast<double>(_expected_items) /
+        (0.95 * detail::cuckoo_bucket::_slot_count)));
+    std::size_t _count = 1;
+    while (_count < _needed)
+        _count <<= 1;
+
+    _allocate(_count);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator>::cuckoo_filter(
+    const cuckoo_filter &_other) :
+    _bucket_allocator(std::allocator_traits<bucket_allocator>::
+                          select_on_container_copy_construction(
+                              _other._bucket_allocator))
+{
+    _copy(_other);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator>::cuckoo_filter(
+    cuckoo_filter &&_other) noexcept :
+    _bucket_allocator(dacal::move(_other._bucket_allocator))
+{
+    _move(_other);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator>::~cuckoo_filter()
+{
+    _destroy();
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator> &
+cuckoo_filter<T, Hash, Allocator>::operator=(const cuckoo_filter &_other)
+{
+    if (this != &_other) {
+        _destroy();
+        _copy(_other);
+    }
+    return *this;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] cuckoo_filter<T, Hash, Allocator> &
+cuckoo_filter<T, Hash, Allocator>::operator=(cuckoo_filter &&_other) noexcept
+{
+    if (this != &_other) {
+        _destroy();
+        _bucket_allocator = _other._bucket_allocator;
+        _move(_other);
+    }
+    return *this;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool cuckoo_filter<T, Hash, Allocator>::insert(
+    typename cuckoo_filter<T, Hash, Allocator>::const_reference _data)
+{
+    if (_has_victim)
+        return false;
+
+    std::size_t _index;
+    uint16_t _fp;
+    _locate(_data, _index, _fp);
+
+    ++_size;
+    if (_add(_index, _fp) || _add(_alternate(_index, _fp), _fp))
+        return true;
+
+    for (std::size_t n = 0; n < _max_kicks; ++n) {
+        // xorshift64, only used to pick which slot to evict
+        _random_state ^= _random_state << 13;
+        _random_state ^= _random_state >> 7;
+        _random_state ^= _random_state << 17;
+
+        if (_random_state & 1)
+            _index = _alternate(_index, _fp);
+        auto &_slot = _buckets[_index]
+                          ._slots[(_random_state >> 1) %
+                                  detail::cuckoo_bucket::_slot_count];
+        dacal::swap(_slot, _fp);
+
+        _index = _alternate(_index, _fp);
+        if (_add(_index, _fp))
+            return true;
+    }
+
+    _has_victim = true;
+    _victim_index = _index;
+    _victim_fp = _fp;
+    return true;
+}
+
+template<class T, class Hash, class Allocator>
+template<InputIterator InIter>
+[[maybe_unused]] std::size_t
+cuckoo_filter<T, Hash, Allocator>::insert(InIter _first, InIter _last)
+{
+    std::size_t _inserted = 0;
+    for (; _first != _last; ++_first) {
+        if (!insert(*_first))
+            break;
+        ++_inserted;
+    }
+    return _inserted;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] bool cuckoo_filter<T, Hash, Allocator>::contains(
+    typename cuckoo_filter<T, Hash, Allocator>::const_reference _data) const
+{
+    std::size_t _index;
+    uint16_t _fp;
+    _locate(_data, _index, _fp);
+
+    auto _alt = _alternate(_index, _fp);
+    auto _in_victim = _has_victim && _victim_fp == _fp &&
+        (_victim_index == _index || _victim_index == _alt);
+    return _in_victim || _has(_index, _fp) || _has(_alt, _fp);
+}
+
+template<class T, class Hash, class Allocator>
+template<InputIterator InIter, OutputIterator OutIter>
+[[maybe_unused]] OutIter cuckoo_filter<T, Hash, Allocator>::contains(
+    InIter _first, InIter _last, OutIter _d_first) const
+{
+    for (; _first != _last; ++_first, ++_d_first) {
+        *_d_first = contains(*_first);
+    }
+    return _d_first;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool cuckoo_filter<T, Hash, Allocator>::erase(
+    typename cuckoo_filter<T, Hash, Allocator>::const_reference _data)
+{
+    std::size_t _index;
+    uint16_t _fp;
+    _locate(_data, _index, _fp);
+
+    auto _alt = _alternate(_index, _fp);
+    if (_has_victim && _victim_fp == _fp &&
+        (_victim_index == _index || _victim_index == _alt)) {
+        _has_victim = false;
+        --_size;
+        return true;
+    }
+
+    if (!_remove(_index, _fp) && !_remove(_alt, _fp))
+        return false;
+
+    --_size;
+    if (_has_victim) {
+        // the freed slot may take the evicted fingerprint back
+        _has_victim = false;
+        if (!_add(_victim_index, _victim_fp) &&
+            !_add(_alternate(_victim_index, _victim_fp), _victim_fp))
+            _has_victim = true;
+    }
+    return true;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void cuckoo_filter<T, Hash, Allocator>::clear()
+{
+    std::memset(_buckets, 0, _bucket_count * sizeof(detail::cuckoo_bucket));
+    _size = 0;
+    _has_victim = false;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+cuckoo_filter<T, Hash, Allocator>::size() const
+{
+    return _size;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+cuckoo_filter<T, Hash, Allocator>::bucket_count() const
+{
+    return _bucket_count;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+cuckoo_filter<T, Hash, Allocator>::fingerprint_bits() const
+{
+    return _fingerprint_bits;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+cuckoo_filter<T, Hash, Allocator>::serialized_size() const
+{
+    return _header_size + _bucket_count * sizeof(detail::cuckoo_bucket);
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] void
+cuckoo_filter<T, Hash, Allocator>::serialize(uint8_t *_buffer) const
+{
+    // native byte order, the buffer is meant to be read back on the same
+    // architecture
+    uint64_t _header[5] = {
+        _bucket_count,
+        _fingerprint_bits,
+        _size,
+        _has_victim ? _victim_index : _bucket_count,
+        _victim_fp};
+    std::memcpy(_buffer, _header, _header_size);
+    std::memcpy(
+        _buffer + _header_size,
+        _buckets,
+        _bucket_count * sizeof(detail::cuckoo_bucket));
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] bool cuckoo_filter<T, Hash, Allocator>::deserialize(
+    const uint8_t *_buffer, std::size_t _bytes)
+{
+    if (_bytes < _header_size)
+        return false;
+
+    uint64_t _header[5];
+    std::memcpy(_header, _buffer, _header_size);
+
+    auto _count = _header[0];
+    if (_count == 0 || (_count & (_count - 1)) != 0 || _header[1] < 4 ||
+        _header[1] > 16 ||
+        (_bytes - _header_size) % sizeof(detail::cuckoo_bucket) != 0 ||
+        (_bytes - _header_size) / sizeof(detail::cuckoo_bucket) != _count)
+        return false;
+
+    _destroy();
+    _allocate(_count);
+    std::memcpy(
+        _buckets,
+        _buffer + _header_size,
+        _bucket_count * sizeof(detail::cuckoo_bucket));
+    _fingerprint_bits = _header[1];
+    _size = _header[2];
+    _has_victim = _header[3] < _count;
+    _victim_index = _has_victim ? _header[3] : 0;
+    _victim_fp = static_cast<uint16_t>(_header[4]);
+    return true;
+}
+
+template<class T, class Hash, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename cuckoo_filter<
+    T, Hash, Allocator>::allocator
+cuckoo_filter<T, Hash, Allocator>::get_allocator() const
+{
+    return allocator(_bucket_allocator);
+}
+
+namespace pmr {
+template<class T, class Hash = dacal::hash<T>>
+using cuckoo_filter = dacal::cuckoo_filter<T, Hash, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace dacal
+
+#endif  // DACAL_CUCKOO_FILTER_HPP
@@ -0,0 +1,119 @@
+#ifndef DACAL_EXECUTION_HPP
+#define DACAL_EXECUTION_HPP
+
+#include "thread_pool.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+namespace dacal::execution {
+// runs on the calling thread, in order
+struct [[maybe_unused]] sequenced_policy
+{};
+
+// splits the range over the threads of a pool, the shared default pool
+// unless on() picks another one
+class [[maybe_unused]] parallel_policy
+{
+public:
+    [[maybe_unused]] constexpr parallel_policy() = default;
+    [[maybe_unused]] constexpr explicit parallel_policy(
+        thread_pool &_thread_pool) :
+        _pool(&_thread_pool)
+    {}
+
+    [[maybe_unused]] [[nodiscard]] parallel_policy
+    on(thread_pool &_thread_pool) const
+    {
+        return parallel_policy(_thread_pool);
+    }
+
+    [[maybe_unused]] [[nodiscard]] thread_pool &pool() const
+    {
+        return _pool != nullptr ? *_pool : default_thread_pool();
+    }
+
+private:
+    thread_pool *_pool{};
+};
+
+// parallel, and the work of one thread may be vectorised; the chunks use the
+// vectorised serial kernels wherever those apply
+class [[maybe_unused]] parallel_unsequenced_policy : public parallel_policy
+{
+public:
+    using parallel_policy::parallel_policy;
+
+    [[maybe_unused]] [[nodiscard]] parallel_unsequenced_policy
+    on(thread_pool &_thread_pool) const
+    {
+        return parallel_unsequenced_policy(_thread_pool);
+    }
+};
+
+[[maybe_unused]] inline constexpr sequenced_policy seq{};
+[[maybe_unused]] inline constexpr parallel_policy par{};
+[[maybe_unused]] inline constexpr parallel_unsequenced_policy par_unseq{};
+
+}  // namespace dacal::execution
+
+namespace dacal {
+template<class T>
+concept ExecutionPolicy =
+    std::is_same_v<std::remove_cvref_t<T>, execution::sequenced_policy> ||
+    std::derived_from<std::remove_cvref_t<T>, execution::parallel_policy>;
+
+}  // namespace dacal
+
+namespace detail {
+// elements a chunk gets at least, less work does not pay for waking a
+// worker
+constexpr std::size_t parallel_grain = 1 << 14;
+
+// chunks per thread, so chunks that take longer than others still balance
+constexpr std::size_t parallel_chunks_per_thread = 4;
+
+// elements searches look at between two checks for an earlier match
+constexpr std::size_t parallel_cancel_block = 1 << 10;
+
+template<class Policy>
+std::size_t parallel_chunk_count(const Policy &policy, std::size_t size)
+{
+    if constexpr (std::is_same_v<Policy, dacal::execution::sequenced_policy>) {
+        return 1;
+    }
+    else {
+        auto chunks = size / parallel_grain;
+        auto limit = policy.pool().size() * parallel_chunks_per_thread;
+        if (chunks > limit)
+            chunks = limit;
+        return chunks > 1 ? chunks : 1;
+    }
+}
+
+// calls func(chunk, low, high) for every chunk of [0, size), spread over the
+// pool of the policy; lower chunks are handed out first
+template<class Policy, class Function>
+void parallel_for_chunks(
+    const Policy &policy,
+    std::size_t size,
+    std::size_t chunks,
+    const Function &func)
+{
+    if constexpr (std::is_same_v<Policy, dacal::execution::sequenced_policy>) {
+        func(0, 0, size);
+    }
+    else {
+        auto chunk_low = [size, chunks](std::size_t chunk) {
+            return chunk * size / chunks;
+        };
+        policy.pool().run(chunks, [&](std::size_t chunk) {
+            func(chunk, chunk_low(chunk), chunk_low(chunk + 1));
+        });
+    }
+}
+
+}  // namespace detail
+
+#endif  // DACAL_EXECUTION_HPP
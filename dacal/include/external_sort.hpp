@@ -0,0 +1,646 @@
+#ifndef DACAL_EXTERNAL_SORT_HPP
+#define DACAL_EXTERNAL_SORT_HPP
+
+#include "loser_tree.hpp"
+#include "quick_sort.hpp"
+#include "utils.hpp"
+#include "vector.hpp"
+
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+namespace dacal {
+struct [[maybe_unused]] external_sort_options
+{
+    // bytes of records held in memory at a time
+    std::size_t memory_budget = std::size_t(1) << 30;
+    // where runs are spilled to, the system temporary directory if empty
+    std::filesystem::path temp_directory;
+};
+
+}  // namespace dacal
+
+namespace detail {
+// bytes a merge reads from a run at a time at least; more runs than the
+// budget has blocks for are merged in several passes
+constexpr std::size_t external_merge_block = 1 << 20;
+
+// records are written to and read from disk as their bytes
+template<class T>
+concept external_record =
+    std::is_trivially_copyable_v<T> && std::default_initializable<T>;
+
+struct file_closer
+{
+    void operator()(std::FILE *file) const
+    {
+        std::fclose(file);
+    }
+};
+
+using file_handle = std::unique_ptr<std::FILE, file_closer>;
+
+inline file_handle
+open_file(const std::filesystem::path &path, const char *mode)
+{
+    return file_handle(std::fopen(path.string().c_str(), mode));
+}
+
+// closing flushes, so a write only succeeded once the close did
+inline bool close_file(file_handle file)
+{
+    return std::fclose(file.release()) == 0;
+}
+
+template<class T>
+bool write_records(file_handle file, const T *records, std::size_t count)
+{
+    auto written = std::fwrite(records, sizeof(T), count, file.get());
+    return close_file(dacal::move(file)) && written == count;
+}
+
+/*
+ *  Runs spilled by one sort. Every file gets a name that did not exist
+ *  yet, made of a random token and its number, and the files still there
+ *  when the sort ends are removed, failed or not; a run renamed to its
+ *  final place is kept.
+ **/
+class run_files
+{
+public:
+    explicit run_files(std::filesystem::path _path);
+    run_files(const run_files &_other) = delete;
+    ~run_files();
+
+    run_files &operator=(const run_files &_other) = delete;
+
+    // opens a new run for writing, nullptr if none can be created
+    [[nodiscard]] file_handle create();
+    void remove(std::size_t _run);
+    // moves a run over target, false if it cannot be renamed
+    [[nodiscard]] bool
+    rename(std::size_t _run, const std::filesystem::path &_target);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::filesystem::path path(std::size_t _run) const;
+
+private:
+    [[nodiscard]] std::filesystem::path
+    _name(std::size_t _token, std::size_t _run) const;
+
+    std::filesystem::path _directory;
+    // the token each run was created with, and whether it still exists
+    dacal::vector<std::size_t> _tokens;
+    dacal::vector<unsigned char> _exists;
+};
+
+inline run_files::run_files(std::filesystem::path _path) :
+    _directory(dacal::move(_path))
+{}
+
+inline run_files::~run_files()
+{
+    for (std::size_t i = 0; i < _tokens.size(); ++i)
+        remove(i);
+}
+
+[[nodiscard]] inline file_handle run_files::create()
+{
+    std::random_device random;
+    auto token = _tokens.size() > 0 ? _tokens[_tokens.size() - 1] : random();
+    // another sort may use the same directory, a taken name draws again
+    for (int attempt = 0; attempt < 16; ++attempt, token = random()) {
+        auto file = open_file(_name(token, _tokens.size()), "wbx");
+        if (file) {
+            _tokens.push_back(token);
+            _exists.push_back(1);
+            return file;
+        }
+    }
+    return nullptr;
+}
+
+inline void run_files::remove(std::size_t _run)
+{
+    if (!_exists[_run])
+        return;
+
+    std::error_code error;
+    std::filesystem::remove(path(_run), error);
+    _exists[_run] = 0;
+}
+
+[[nodiscard]] inline bool
+run_files::rename(std::size_t _run, const std::filesystem::path &_target)
+{
+    std::error_code error;
+    std::filesystem::rename(path(_run), _target, error);
+    if (error)
+        return false;
+    _exists[_run] = 0;
+    return true;
+}
+
+[[nodiscard]] inline std::size_t run_files::size() const
+{
+    return _tokens.size();
+}
+
+[[nodiscard]] inline std::filesystem::path
+run_files::path(std::size_t _run) const
+{
+    return _name(_tokens[_run], _run);
+}
+
+[[nodiscard]] inline std::filesystem::path
+run_files::_name(std::size_t _token, std::size_t _run) const
+{
+    return _directory /
+        ("dacal-sort-" + std::to_string(_token) + "-" + std::to_string(_run));
+}
+
+/*
+ *  The thread one sort hands its block reads and writes to. Requests are
+ *  carried out one at a time in the order they came in, so a merge of any
+ *  fan-in overlaps its disk access with one thread rather than one per
+ *  pending block.
+ **/
+class io_thread
+{
+public:
+    // fread or fwrite of count records; the caller keeps it alive until
+    // wait() returned
+    struct request
+    {
+        std::FILE *_file{};
+        void *_buffer{};
+        std::size_t _record{};
+        std::size_t _count{};
+        bool _write{};
+        // records read or written, valid once done
+        std::size_t _moved{};
+        bool _done{};
+        request *_successor{};
+    };
+
+    io_thread();
+    io_thread(const io_thread &_other) = delete;
+    ~io_thread();
+
+    io_thread &operator=(const io_thread &_other) = delete;
+
+    void submit(request &_request);
+    // waits until a submitted request is done, the records it moved
+    [[nodiscard]] std::size_t wait(request &_request);
+
+private:
+    void _serve();
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    request *_head{};
+    request *_tail{};
+    bool _stopping{};
+    // declared last, it starts once the rest is there
+    std::thread _thread;
+};
+
+inline io_thread::io_thread() : _thread([this] { _serve(); }) {}
+
+inline io_thread::~io_thread()
+{
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+inline void io_thread::submit(request &_request)
+{
+    _request._done = false;
+    _request._successor = nullptr;
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        (_tail != nullptr ? _tail->_successor : _head) = &_request;
+        _tail = &_request;
+    }
+    _wake.notify_one();
+}
+
+[[nodiscard]] inline std::size_t io_thread::wait(request &_request)
+{
+    std::unique_lock<std::mutex> _lock(_mutex);
+    _done.wait(_lock, [&] { return _request._done; });
+    return _request._moved;
+}
+
+inline void io_thread::_serve()
+{
+    std::unique_lock<std::mutex> _lock(_mutex);
+    for (;;) {
+        // what is queued is still carried out once stopping
+        _wake.wait(_lock, [this] { return _stopping || _head != nullptr; });
+        if (_head == nullptr)
+            return;
+        auto _request = _head;
+        _head = _request->_successor;
+        if (_head == nullptr)
+            _tail = nullptr;
+
+        _lock.unlock();
+        auto _moved = _request->_write
+            ? std::fwrite(
+                  _request->_buffer,
+                  _request->_record,
+                  _request->_count,
+                  _request->_file)
+            : std::fread(
+                  _request->_buffer,
+                  _request->_record,
+                  _request->_count,
+                  _request->_file);
+        _lock.lock();
+
+        _request->_moved = _moved;
+        _request->_done = true;
+        _done.notify_all();
+    }
+}
+
+/*
+ *  Hands out the records of a file one at a time, reading them in blocks.
+ *  The next block is read on the I/O thread while the current one is
+ *  handed out, so the merge waits for the disk only when it is faster.
+ **/
+template<class T>
+class block_reader
+{
+public:
+    block_reader(io_thread &_thread, file_handle _handle, std::size_t _records);
+    block_reader(const block_reader &_other) = delete;
+    ~block_reader();
+
+    block_reader &operator=(const block_reader &_other) = delete;
+
+    // the current record, nullptr once the file is exhausted
+    [[nodiscard]] const T *head() const;
+    void advance();
+    [[nodiscard]] bool failed() const;
+
+private:
+    void _read_ahead();
+    void _next_block();
+
+    io_thread &_io;
+    file_handle _file;
+    std::size_t _block;
+    std::unique_ptr<T[]> _buffers[2];
+    std::size_t _reading{};
+    const T *_next{};
+    const T *_end{};
+    bool _failed{};
+    io_thread::request _request;
+    bool _pending{};
+};
+
+template<class T>
+block_reader<T>::block_reader(
+    io_thread &_thread, file_handle _handle, std::size_t _records) :
+    _io(_thread),
+    _file(dacal::move(_handle)),
+    _block(_records),
+    _buffers{
+        std::unique_ptr<T[]>(new T[_block]),
+        std::unique_ptr<T[]>(new T[_block])}
+{
+    _read_ahead();
+    _next_block();
+}
+
+template<class T>
+block_reader<T>::~block_reader()
+{
+    // the I/O thread may still fill a buffer
+    if (_pending)
+        (void)_io.wait(_request);
+}
+
+template<class T>
+[[nodiscard]] const T *block_reader<T>::head() const
+{
+    return _next != _end ? _next : nullptr;
+}
+
+template<class T>
+void block_reader<T>::advance()
+{
+    if (++_next == _end)
+        _next_block();
+}
+
+template<class T>
+[[nodiscard]] bool block_reader<T>::failed() const
+{
+    return _failed;
+}
+
+template<class T>
+void block_reader<T>::_read_ahead()
+{
+    _request = {_file.get(), _buffers[_reading].get(), sizeof(T), _block};
+    _io.submit(_request);
+    _pending = true;
+}
+
+template<class T>
+void block_reader<T>::_next_block()
+{
+    // a short block was the last one
+    if (!_pending)
+        return;
+
+    _pending = false;
+    auto count = _io.wait(_request);
+    _next = _buffers[_reading].get();
+    _end = _next + count;
+    if (count < _block) {
+        _failed = std::ferror(_file.get()) != 0;
+        return;
+    }
+    _reading ^= 1;
+    _read_ahead();
+}
+
+// gathers records into blocks and writes every full block on the I/O
+// thread while the next one fills
+template<class T>
+class block_writer
+{
+public:
+    block_writer(io_thread &_thread, file_handle _handle, std::size_t _records);
+    block_writer(const block_writer &_other) = delete;
+    ~block_writer();
+
+    block_writer &operator=(const block_writer &_other) = delete;
+
+    void push(const T &_record);
+    // writes what is left and closes the file, false if any write failed
+    [[nodiscard]] bool finish();
+
+private:
+    void _write_block();
+    void _wait();
+
+    io_thread &_io;
+    file_handle _file;
+    std::size_t _block;
+    std::unique_ptr<T[]> _buffers[2];
+    std::size_t _filling{};
+    T *_next;
+    T *_end;
+    bool _failed{};
+    io_thread::request _request;
+    bool _pending{};
+};
+
+template<class T>
+block_writer<T>::block_writer(
+    io_thread &_thread, file_handle _handle, std::size_t _records) :
+    _io(_thread),
+    _file(dacal::move(_handle)),
+    _block(_records),
+    _buffers{
+        std::unique_ptr<T[]>(new T[_block]),
+        std::unique_ptr<T[]>(new T[_block])},
+    _next(_buffers[0].get()),
+    _end(_next + _block)
+{}
+
+template<class T>
+block_writer<T>::~block_writer()
+{
+    _wait();
+}
+
+template<class T>
+void block_writer<T>::push(const T &_record)
+{
+    *_next = _record;
+    if (++_next == _end)
+        _write_block();
+}
+
+template<class T>
+[[nodiscard]] bool block_writer<T>::finish()
+{
+    if (_next != _buffers[_filling].get())
+        _write_block();
+    _wait();
+    return close_file(dacal::move(_file)) && !_failed;
+}
+
+template<class T>
+void block_writer<T>::_write_block()
+{
+    _wait();
+    T *buffer = _buffers[_filling].get();
+    auto count = static_cast<std::size_t>(_next - buffer);
+    _request = {_file.get(), buffer, sizeof(T), count, true};
+    _io.submit(_request);
+    _pending = true;
+
+    _filling ^= 1;
+    _next = _buffers[_filling].get();
+    _end = _next + _block;
+}
+
+template<class T>
+void block_writer<T>::_wait()
+{
+    if (!_pending)
+        return;
+
+    _pending = false;
+    if (_io.wait(_request) != _request._count)
+        _failed = true;
+}
+
+// merges count sorted runs from first on into output with a loser tree, the
+// budget split evenly over the blocks of the readers and the writer
+template<class T, class Compare>
+bool merge_runs(
+    io_thread &io,
+    const run_files &runs,
+    std::size_t first,
+    std::size_t count,
+    file_handle output,
+    std::size_t budget,
+    const Compare &compare)
+{
+    auto block = budget / sizeof(T) / (2 * (count + 1));
+    block = block > 0 ? block : 1;
+
+    std::unique_ptr<std::unique_ptr<block_reader<T>>[]> readers(
+        new std::unique_ptr<block_reader<T>>[count]);
+    auto less = [&readers, &compare](std::size_t lhs, std::size_t rhs) {
+        return compare(*readers[lhs]->head(), *readers[rhs]->head());
+    };
+    loser_tree<decltype(less)> tree(count, less);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto file = open_file(runs.path(first + i), "rb");
+        if (!file)
+            return false;
+        readers[i].reset(new block_reader<T>(io, dacal::move(file), block));
+        if (readers[i]->head() == nullptr)
+            tree.exhaust(i);
+    }
+    tree.build();
+
+    block_writer<T> writer(io, dacal::move(output), block);
+    while (!tree.empty()) {
+        auto winner = tree.winner();
+        writer.push(*readers[winner]->head());
+        readers[winner]->advance();
+        if (readers[winner]->head() == nullptr)
+            tree.exhaust(winner);
+        tree.replay();
+    }
+
+    auto merged = writer.finish();
+    for (std::size_t i = 0; i < count; ++i)
+        merged = merged && !readers[i]->failed();
+    return merged;
+}
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Sorts a file of fixed size records that need not fit in memory into
+ *  another file, which may be the same one. Half of the memory budget is
+ *  sorted with quick_sort and spilled to a run file while the other half
+ *  is read, then the runs are merged with a loser tree, reading and
+ *  writing in blocks on an I/O thread. More runs than the budget has room
+ *  for are merged in several passes; an input that fits is sorted without
+ *  any run files. Equal records may change order. The result is written
+ *  to a new file next to the output and renamed over it once complete.
+ *
+ *  Returns false if a file could not be read or written, or the input size
+ *  is not a multiple of the record size; the output is left as it was.
+ **/
+template<detail::external_record T, class Compare = dacal::less<T>>
+[[maybe_unused]] [[nodiscard]] bool external_sort(
+    const std::filesystem::path &_input,
+    const std::filesystem::path &_output,
+    const Compare &_compare = Compare(),
+    const external_sort_options &_options = external_sort_options())
+{
+    std::error_code _error;
+    auto _bytes = std::filesystem::file_size(_input, _error);
+    if (_error || _bytes % sizeof(T) != 0)
+        return false;
+    auto _directory = _options.temp_directory;
+    if (_directory.empty())
+        _directory = std::filesystem::temp_directory_path(_error);
+    if (_error)
+        return false;
+
+    auto _total = static_cast<std::size_t>(_bytes / sizeof(T));
+    auto _records = _options.memory_budget / sizeof(T) / 2;
+    _records = _records < _total ? _records : _total;
+    _records = _records > 0 ? _records : 1;
+    // every reader and the writer hold two blocks
+    auto _blocks = _options.memory_budget / detail::external_merge_block;
+    auto _fan_in = _blocks / 2 > 3 ? _blocks / 2 - 1 : 2;
+
+    detail::io_thread _io;
+    detail::run_files _runs(_directory);
+    detail::run_files _staging(_output.parent_path());
+    {
+        auto _in = detail::open_file(_input, "rb");
+        if (!_in)
+            return false;
+
+        std::unique_ptr<T[]> _buffers[2]{
+            std::unique_ptr<T[]>(new T[_records]),
+            std::unique_ptr<T[]>(new T[_records])};
+        detail::io_thread::request _pending;
+        auto _read = [&](std::size_t buffer) {
+            _pending = {_in.get(), _buffers[buffer].get(), sizeof(T), _records};
+            _io.submit(_pending);
+        };
+
+        _read(0);
+        auto _count = _io.wait(_pending);
+        if (_count == _total) {
+            _in.reset();
+            detail::quick_sort(_buffers[0].get(), _count, _compare);
+            auto _out = _staging.create();
+            return _out &&
+                detail::write_records(
+                       dacal::move(_out), _buffers[0].get(), _count) &&
+                _staging.rename(0, _output);
+        }
+
+        for (std::size_t _current = 0; _count > 0; _current ^= 1) {
+            _read(_current ^ 1);
+            detail::quick_sort(_buffers[_current].get(), _count, _compare);
+            auto _run = _runs.create();
+            auto _written = _run &&
+                detail::write_records(
+                    dacal::move(_run), _buffers[_current].get(), _count);
+            // the buffer being read into has to outlive the read
+            _count = _io.wait(_pending);
+            if (!_written)
+                return false;
+        }
+        if (std::ferror(_in.get()))
+            return false;
+    }
+
+    std::size_t _first_run = 0;
+    for (; _runs.size() - _first_run > _fan_in; _first_run += _fan_in) {
+        auto _run = _runs.create();
+        if (!_run ||
+            !detail::merge_runs<T>(
+                _io,
+                _runs,
+                _first_run,
+                _fan_in,
+                dacal::move(_run),
+                _options.memory_budget,
+                _compare))
+            return false;
+        for (std::size_t i = 0; i < _fan_in; ++i)
+            _runs.remove(_first_run + i);
+    }
+
+    auto _out = _staging.create();
+    return _out &&
+        detail::merge_runs<T>(
+               _io,
+               _runs,
+               _first_run,
+               _runs.size() - _first_run,
+               dacal::move(_out),
+               _options.memory_budget,
+               _compare) &&
+        _staging.rename(0, _output);
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_EXTERNAL_SORT_HPP
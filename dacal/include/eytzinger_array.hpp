@@ -0,0 +1,311 @@
+#ifndef DACAL_EYTZINGER_ARRAY_HPP
+#define DACAL_EYTZINGER_ARRAY_HPP
+
+#include "binary_search.hpp"
+#include "iterator.hpp"
+#include "utils.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace detail {
+// storage is allocated in cache lines so the prefetched descendants of a
+// node share one line
+struct alignas(64) eytzinger_line
+{
+    unsigned char _bytes[64];
+};
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Sorted values laid out in breadth first order of a complete binary
+ *  search tree: the root at index 1, the children of k at 2k and 2k + 1.
+ *  A search walks down from the root, so the first levels stay in cache
+ *  for every search, and the 64 / sizeof(T) descendants a few levels below
+ *  a node sit in one cache line that is prefetched while the levels above
+ *  it are compared. Built once from sorted input, there are no inserts.
+ **/
+template<
+    class T,
+    class Compare = dacal::less<T>,
+    class Allocator = std::allocator<T>>
+class [[maybe_unused]] eytzinger_array
+{
+public:
+    using value_type = T;
+    using const_reference = const T &;
+    using const_pointer = const T *;
+    using value_compare = Compare;
+    using allocator = Allocator;
+    using line_allocator = typename std::allocator_traits<
+        allocator>::template rebind_alloc<detail::eytzinger_line>;
+
+    [[maybe_unused]] explicit eytzinger_array(
+        const Compare &_comp = Compare(),
+        const allocator &_alloc = allocator());
+    // [_first, _last) has to be sorted under _comp
+    template<ForwardIterator FwdIter>
+    [[maybe_unused]] eytzinger_array(
+        FwdIter _first,
+        FwdIter _last,
+        const Compare &_comp = Compare(),
+        const allocator &_alloc = allocator());
+    [[maybe_unused]] eytzinger_array(const eytzinger_array &_other);
+    [[maybe_unused]] eytzinger_array(eytzinger_array &&_other) noexcept;
+    [[maybe_unused]] ~eytzinger_array();
+
+    [[maybe_unused]] eytzinger_array &operator=(const eytzinger_array &_other);
+    [[maybe_unused]] eytzinger_array &
+    operator=(eytzinger_array &&_other) noexcept;
+
+    // the smallest element not less than _value, nullptr if there is none
+    [[maybe_unused]] [[nodiscard]] const_pointer
+    lower_bound(const_reference _value) const;
+    // the smallest element greater than _value, nullptr if there is none
+    [[maybe_unused]] [[nodiscard]] const_pointer
+    upper_bound(const_reference _value) const;
+    [[maybe_unused]] [[nodiscard]] bool contains(const_reference _value) const;
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
+
+private:
+    // elements in one cache line, the tree levels a prefetch reaches ahead
+    static constexpr std::size_t _line_elements =
+        sizeof(T) <= 64 && 64 % sizeof(T) == 0 ? 64 / sizeof(T) : 0;
+
+    [[maybe_unused]] void _allocate(std::size_t _count);
+    [[maybe_unused]] void _destroy();
+    template<class Predicate>
+    [[maybe_unused]] std::size_t _descend(const Predicate &_go_right) const;
+
+    line_allocator _line_allocator;
+    Compare _compare;
+    // one based, _data[0] is never constructed
+    T *_data{};
+    std::size_t _size{};
+    std::size_t _line_count{};
+};
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] void
+eytzinger_array<T, Compare, Allocator>::_allocate(std::size_t _count)
+{
+    _size = _count;
+    if (_size == 0)
+        return;
+
+    constexpr auto _line = sizeof(detail::eytzinger_line);
+    _line_count = ((_size + 1) * sizeof(T) + _line - 1) / _line;
+    _data = reinterpret_cast<T *>(
+        std::allocator_traits<line_allocator>::allocate(
+            _line_allocator, _line_count));
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] void eytzinger_array<T, Compare, Allocator>::_destroy()
+{
+    if (_data) {
+        for (std::size_t k = 1; k <= _size; ++k)
+            _data[k].~T();
+        std::allocator_traits<line_allocator>::deallocate(
+            _line_allocator,
+            reinterpret_cast<detail::eytzinger_line *>(_data),
+            _line_count);
+    }
+    _data = nullptr;
+    _size = 0;
+    _line_count = 0;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator>::eytzinger_array(
+    const Compare &_comp, const allocator &_alloc) :
+    _line_allocator(_alloc),
+    _compare(_comp)
+{}
+
+template<class T, class Compare, class Allocator>
+template<ForwardIterator FwdIter>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator>::eytzinger_array(
+    FwdIter _first,
+    FwdIter _last,
+    const Compare &_comp,
+    const allocator &_alloc) :
+    _line_allocator(_alloc),
+    _compare(_comp)
+{
+    std::size_t _count = 0;
+    for (auto _it = _first; _it != _last; ++_it)
+        ++_count;
+    _allocate(_count);
+    if (_count == 0)
+        return;
+
+    // an in order walk of the tree visits the slots in sorted order, so the
+    // input is read once from front to back
+    std::size_t k = std::bit_floor(_count);
+    for (; _first != _last; ++_first) {
+        ::new (static_cast<void *>(_data + k)) T(*_first);
+        if (2 * k + 1 <= _count) {
+            k = 2 * k + 1;
+            while (2 * k <= _count)
+                k *= 2;
+        }
+        else {
+            // up past every ancestor whose right subtree this was
+            k >>= std::countr_one(k) + 1;
+        }
+    }
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator>::eytzinger_array(
+    const eytzinger_array &_other) :
+    _line_allocator(std::allocator_traits<line_allocator>::
+                        select_on_container_copy_construction(
+                            _other._line_allocator)),
+    _compare(_other._compare)
+{
+    _allocate(_other._size);
+    for (std::size_t k = 1; k <= _size; ++k)
+        ::new (static_cast<void *>(_data + k)) T(_other._data[k]);
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator>::eytzinger_array(
+    eytzinger_array &&_other) noexcept :
+    _line_allocator(dacal::move(_other._line_allocator)),
+    _compare(dacal::move(_other._compare))
+{
+    _data = dacal::exchange(_other._data, nullptr);
+    _size = dacal::exchange(_other._size, 0);
+    _line_count = dacal::exchange(_other._line_count, 0);
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator>::~eytzinger_array()
+{
+    _destroy();
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator> &
+eytzinger_array<T, Compare, Allocator>::operator=(
+    const eytzinger_array &_other)
+{
+    if (this != &_other) {
+        _destroy();
+        _compare = _other._compare;
+        _allocate(_other._size);
+        for (std::size_t k = 1; k <= _size; ++k)
+            ::new (static_cast<void *>(_data + k)) T(_other._data[k]);
+    }
+    return *this;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] eytzinger_array<T, Compare, Allocator> &
+eytzinger_array<T, Compare, Allocator>::operator=(
+    eytzinger_array &&_other) noexcept
+{
+    if (this != &_other) {
+        _destroy();
+        // the lines can only be released by the allocator that made them
+        _line_allocator = _other._line_allocator;
+        _compare = dacal::move(_other._compare);
+        _data = dacal::exchange(_other._data, nullptr);
+        _size = dacal::exchange(_other._size, 0);
+        _line_count = dacal::exchange(_other._line_count, 0);
+    }
+    return *this;
+}
+
+/*
+ *  Walks from the root to below a leaf, going right wherever _go_right
+ *  holds. The walk ends with a right turn past every element _go_right
+ *  holds for; dropping those turns and the left turn before them lands on
+ *  the first element it does not hold for, or on 0 if there is none.
+ **/
+template<class T, class Compare, class Allocator>
+template<class Predicate>
+[[maybe_unused]] std::size_t
+eytzinger_array<T, Compare, Allocator>::_descend(
+    const Predicate &_go_right) const
+{
+    std::size_t k = 1;
+    while (k <= _size) {
+        if constexpr (_line_elements != 0) {
+            detail::prefetch(
+                reinterpret_cast<std::uintptr_t>(_data) +
+                k * _line_elements * sizeof(T));
+        }
+        k = 2 * k + static_cast<std::size_t>(_go_right(_data[k]));
+    }
+    return k >> (std::countr_one(k) + 1);
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]]
+typename eytzinger_array<T, Compare, Allocator>::const_pointer
+eytzinger_array<T, Compare, Allocator>::lower_bound(
+    const_reference _value) const
+{
+    auto k = _descend([this, &_value](const_reference _element) {
+        return _compare(_element, _value);
+    });
+    return k != 0 ? _data + k : nullptr;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]]
+typename eytzinger_array<T, Compare, Allocator>::const_pointer
+eytzinger_array<T, Compare, Allocator>::upper_bound(
+    const_reference _value) const
+{
+    auto k = _descend([this, &_value](const_reference _element) {
+        return !_compare(_value, _element);
+    });
+    return k != 0 ? _data + k : nullptr;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] bool
+eytzinger_array<T, Compare, Allocator>::contains(const_reference _value) const
+{
+    auto _found = lower_bound(_value);
+    return _found != nullptr && !_compare(_value, *_found);
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+eytzinger_array<T, Compare, Allocator>::size() const
+{
+    return _size;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]]
+typename eytzinger_array<T, Compare, Allocator>::allocator
+eytzinger_array<T, Compare, Allocator>::get_allocator() const
+{
+    return allocator(_line_allocator);
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+eytzinger_array<T, Compare, Allocator>::memory_usage() const
+{
+    auto _bytes = _line_count * sizeof(detail::eytzinger_line);
+    return {_size * sizeof(T), _bytes - _size * sizeof(T) + sizeof(*this)};
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_EYTZINGER_ARRAY_HPP
@@ -2,6 +2,8 @@
 #define DACAL_FORWARD_LIST_HPP
 
 #include "iterator.hpp"
+#include "memory_resource.hpp"
+#include "merge_sort.hpp"
 #include "utils.hpp"
 
 #include <initializer_list>
@@ -145,6 +147,7 @@ public:
         allocator>::template rebind_alloc<detail::forward_list_node<T>>;
 
     [[maybe_unused]] forward_list() = default;
+    [[maybe_unused]] explicit forward_list(const allocator &_alloc);
     [[maybe_unused]] forward_list(const forward_list<T, Allocator> &_other);
     [[maybe_unused]] forward_list(forward_list &&_other) noexcept;
     [[maybe_unused]] forward_list(const std::initializer_list<T> &initializer);
@@ -167,6 +170,19 @@ public:
     [[maybe_unused]] [[nodiscard]] value_type pop_back();
     [[maybe_unused]] [[nodiscard]] value_type pop_front();
 
+    template<class Compare = dacal::less<T>>
+    [[maybe_unused]] void sort(const Compare &_compare = Compare{});
+    template<class Compare = dacal::less<T>>
+    [[maybe_unused]] void merge(
+        forward_list<T, Allocator> &_other,
+        const Compare &_compare = Compare{});
+    [[maybe_unused]] std::size_t unique();
+    template<class BinaryPredicate>
+    [[maybe_unused]] std::size_t unique(const BinaryPredicate &_predicate);
+
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
+
 private:
     [[maybe_unused]] void _push(const T &data);
     [[maybe_unused]] void _destroy();
@@ -210,7 +226,18 @@ template<class T, class Allocator>
 
 template<class T, class Allocator>
 [[maybe_unused]] forward_list<T, Allocator>::forward_list(
-    const forward_list<T, Allocator> &_other)
+    const allocator &_alloc) :
+    _allocator(_alloc),
+    _node_allocator(_alloc)
+{}
+
+template<class T, class Allocator>
+[[maybe_unused]] forward_list<T, Allocator>::forward_list(
+    const forward_list<T, Allocator> &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator)),
+    _node_allocator(_allocator)
 {
     for (auto i = _other._list_head; i != nullptr; i = i->_successor) {
         _push(i->_data);
@@ -219,7 +246,9 @@ template<class T, class Allocator>
 
 template<class T, class Allocator>
 [[maybe_unused]] forward_list<T, Allocator>::forward_list(
-    forward_list &&_other) noexcept
+    forward_list &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator)),
+    _node_allocator(dacal::move(_other._node_allocator))
 {
     this->_list_head = exchange(_other._list_head, nullptr);
 }
@@ -256,7 +285,14 @@ template<class T, class Allocator>
 forward_list<T, Allocator>::operator=(
     forward_list<T, Allocator> &&_other) noexcept
 {
-    this->_list_head = exchange(_other._list_head, nullptr);
+    if (this != &_other) {
+        _destroy();
+
+        // the nodes can only be released by the allocator that made them
+        _allocator = _other._allocator;
+        _node_allocator = _other._node_allocator;
+        this->_list_head = exchange(_other._list_head, nullptr);
+    }
     return *this;
 }
 
@@ -379,6 +415,80 @@ template<class T, class Allocator>
     return ret_value;
 }
 
+template<class T, class Allocator>
+template<class Compare>
+[[maybe_unused]] void forward_list<T, Allocator>::sort(const Compare &_compare)
+{
+    _list_head = detail::merge_sort_nodes(_list_head, _compare);
+}
+
+template<class T, class Allocator>
+template<class Compare>
+[[maybe_unused]] void forward_list<T, Allocator>::merge(
+    forward_list<T, Allocator> &_other, const Compare &_compare)
+{
+    if (this != &_other) {
+        _list_head = detail::merge_nodes(
+            _list_head, exchange(_other._list_head, nullptr), _compare);
+    }
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] std::size_t forward_list<T, Allocator>::unique()
+{
+    return unique([](const T &_lhs, const T &_rhs) { return _lhs == _rhs; });
+}
+
+template<class T, class Allocator>
+template<class BinaryPredicate>
+[[maybe_unused]] std::size_t
+forward_list<T, Allocator>::unique(const BinaryPredicate &_predicate)
+{
+    std::size_t _removed = 0;
+    for (auto i = _list_head; i != nullptr && i->_successor != nullptr;) {
+        auto successor = i->_successor;
+        if (_predicate(i->_data, successor->_data)) {
+            i->_successor = successor->_successor;
+            std::allocator_traits<allocator>::destroy(_allocator, successor);
+            std::allocator_traits<node_allocator>::deallocate(
+                _node_allocator, successor, 1);
+            ++_removed;
+        }
+        else {
+            i = successor;
+        }
+    }
+    return _removed;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename forward_list<T, Allocator>::allocator
+forward_list<T, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+forward_list<T, Allocator>::memory_usage() const
+{
+    std::size_t _count = 0;
+    for (auto i = _list_head; i != nullptr; i = i->_successor) {
+        ++_count;
+    }
+
+    return {
+        _count * sizeof(T),
+        _count * (sizeof(detail::forward_list_node<T>) - sizeof(T)) +
+            sizeof(*this)};
+}
+
+namespace pmr {
+template<class T>
+using forward_list = dacal::forward_list<T, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace dacal
 
 #endif  // DACAL_FORWARD_LIST_HPP
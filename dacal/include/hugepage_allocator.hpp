@@ -0,0 +1,177 @@
+#ifndef DACAL_HUGEPAGE_ALLOCATOR_HPP
+#define DACAL_HUGEPAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace detail {
+constexpr std::size_t hugepage_size = 2 * 1024 * 1024;
+
+constexpr std::size_t hugepage_round(std::size_t bytes)
+{
+    return (bytes + hugepage_size - 1) & ~(hugepage_size - 1);
+}
+
+#if defined(__linux__)
+// maps bytes, a multiple of the huge page size, starting on a huge page
+// boundary so the kernel can back all of it with huge pages: one huge page
+// more is mapped and the parts outside the aligned span are unmapped again.
+// nullptr if the mapping fails
+inline void *hugepage_map(std::size_t bytes)
+{
+    auto mapped = ::mmap(
+        nullptr,
+        bytes + hugepage_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (mapped == MAP_FAILED)
+        return nullptr;
+
+    auto address = reinterpret_cast<std::uintptr_t>(mapped);
+    auto head = hugepage_round(address) - address;
+    auto start = static_cast<char *>(mapped) + head;
+    if (head > 0)
+        ::munmap(mapped, head);
+    ::munmap(start + bytes, hugepage_size - head);
+
+    // only a hint, kernels without THP just keep using 4K pages
+    ::madvise(start, bytes, MADV_HUGEPAGE);
+    return start;
+}
+#endif
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Buffers of at least one huge page are mapped directly and advised for
+ *  transparent huge pages, smaller ones come from operator new. Mapped
+ *  buffers can grow in place or be moved by the kernel with reallocate(),
+ *  which vector uses instead of copying.
+ **/
+template<class T>
+class [[maybe_unused]] hugepage_allocator
+{
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    [[maybe_unused]] hugepage_allocator() noexcept = default;
+
+    template<class U>
+    [[maybe_unused]] hugepage_allocator(const hugepage_allocator<U> &) noexcept
+    {}
+
+    [[maybe_unused]] [[nodiscard]] T *allocate(std::size_t _n);
+    [[maybe_unused]] void deallocate(T *_ptr, std::size_t _n) noexcept;
+    [[maybe_unused]] [[nodiscard]] T *
+    reallocate(T *_ptr, std::size_t _old_n, std::size_t _new_n) noexcept;
+
+    template<class U>
+    [[maybe_unused]] bool operator==(const hugepage_allocator<U> &) const
+    {
+        return true;
+    }
+
+    template<class U>
+    [[maybe_unused]] bool operator!=(const hugepage_allocator<U> &) const
+    {
+        return false;
+    }
+
+private:
+    [[maybe_unused]] static bool _is_mapped(std::size_t _n)
+    {
+#if defined(__linux__)
+        return _n * sizeof(T) >= detail::hugepage_size &&
+            alignof(T) <= 4096;
+#else
+        return false;
+#endif
+    }
+};
+
+template<class T>
+[[maybe_unused]] [[nodiscard]] T *
+hugepage_allocator<T>::allocate(std::size_t _n)
+{
+    if (!_is_mapped(_n))
+        return static_cast<T *>(
+            ::operator new(_n * sizeof(T), std::align_val_t(alignof(T))));
+
+#if defined(__linux__)
+    auto _ptr = detail::hugepage_map(detail::hugepage_round(_n * sizeof(T)));
+    if (_ptr == nullptr)
+        throw std::bad_alloc();
+    return static_cast<T *>(_ptr);
+#else
+    return nullptr;
+#endif
+}
+
+template<class T>
+[[maybe_unused]] void
+hugepage_allocator<T>::deallocate(T *_ptr, std::size_t _n) noexcept
+{
+    if (_ptr == nullptr)
+        return;
+
+    if (!_is_mapped(_n)) {
+        ::operator delete(_ptr, std::align_val_t(alignof(T)));
+        return;
+    }
+
+#if defined(__linux__)
+    ::munmap(_ptr, detail::hugepage_round(_n * sizeof(T)));
+#endif
+}
+
+template<class T>
+[[maybe_unused]] [[nodiscard]] T *hugepage_allocator<T>::reallocate(
+    T *_ptr, std::size_t _old_n, std::size_t _new_n) noexcept
+{
+    // only a mapping can be remapped, anything else is left to the caller
+    if (!_is_mapped(_old_n) || !_is_mapped(_new_n))
+        return nullptr;
+
+#if defined(__linux__)
+    auto _old_bytes = detail::hugepage_round(_old_n * sizeof(T));
+    auto _new_bytes = detail::hugepage_round(_new_n * sizeof(T));
+    if (::mremap(_ptr, _old_bytes, _new_bytes, 0) != MAP_FAILED) {
+        ::madvise(_ptr, _new_bytes, MADV_HUGEPAGE);
+        return _ptr;
+    }
+
+    // a move lets the kernel pick any address, so the pages are moved into
+    // a fresh aligned mapping instead, which still copies nothing
+    auto _new_ptr = detail::hugepage_map(_new_bytes);
+    if (_new_ptr == nullptr)
+        return nullptr;
+    if (::mremap(
+            _ptr,
+            _old_bytes,
+            _old_bytes,
+            MREMAP_MAYMOVE | MREMAP_FIXED,
+            _new_ptr) == MAP_FAILED) {
+        ::munmap(_new_ptr, _new_bytes);
+        return nullptr;
+    }
+
+    ::madvise(_new_ptr, _new_bytes, MADV_HUGEPAGE);
+    return static_cast<T *>(_new_ptr);
+#else
+    return nullptr;
+#endif
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_HUGEPAGE_ALLOCATOR_HPP
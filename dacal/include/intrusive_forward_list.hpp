@@ -0,0 +1,361 @@
+#ifndef DACAL_INTRUSIVE_FORWARD_LIST_HPP
+#define DACAL_INTRUSIVE_FORWARD_LIST_HPP
+
+#include "intrusive_list.hpp"
+#include "iterator.hpp"
+#include "utils.hpp"
+
+#include <cassert>
+#include <cstddef>
+
+namespace dacal {
+struct [[maybe_unused]] forward_list_hook
+{
+    [[maybe_unused]] forward_list_hook() = default;
+
+    // an object copy is a new object, it is not linked anywhere
+    [[maybe_unused]] forward_list_hook(const forward_list_hook &) {}
+    [[maybe_unused]] forward_list_hook &operator=(const forward_list_hook &)
+    {
+        return *this;
+    }
+
+    [[maybe_unused]] ~forward_list_hook()
+    {
+#if DACAL_INTRUSIVE_SAFE_MODE
+        assert(!is_linked() && "object destroyed while still in a list");
+#endif
+    }
+
+#if DACAL_INTRUSIVE_SAFE_MODE
+    [[maybe_unused]] [[nodiscard]] bool is_linked() const
+    {
+        return _linked;
+    }
+#endif
+
+    forward_list_hook *_successor{};
+
+#if DACAL_INTRUSIVE_SAFE_MODE
+    // the last element has a null successor, so linkage is tracked apart
+    bool _linked{};
+#endif
+};
+
+}  // namespace dacal
+
+namespace detail {
+template<class T, dacal::forward_list_hook T::*Hook>
+struct [[maybe_unused]] intrusive_forward_list_iterator
+    : dacal::
+          base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>
+{
+    using typename dacal::
+        base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>::
+            iterator_category;
+
+    using typename dacal::
+        base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>::
+            value_type;
+
+    using typename dacal::
+        base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>::
+            difference_type;
+
+    using typename dacal::
+        base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>::
+            pointer;
+
+    using typename dacal::
+        base_iterator<dacal::forward_iterator_tag, T, std::size_t, T *, T &>::
+            reference;
+
+    [[maybe_unused]] explicit intrusive_forward_list_iterator(
+        dacal::forward_list_hook *ptr) :
+        _ptr(ptr)
+    {}
+    [[maybe_unused]] intrusive_forward_list_iterator() = default;
+
+    [[maybe_unused]] intrusive_forward_list_iterator &operator++()
+    {
+        this->_ptr = this->_ptr->_successor;
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator++(int) -> intrusive_forward_list_iterator
+    {
+        auto _temp = *this;
+        this->_ptr = this->_ptr->_successor;
+        return _temp;
+    }
+
+    [[maybe_unused]] bool operator!=(const intrusive_forward_list_iterator &i)
+    {
+        return this->_ptr != i._ptr;
+    }
+
+    [[maybe_unused]] reference operator*()
+    {
+        return *intrusive_owner<T, dacal::forward_list_hook, Hook>(_ptr);
+    }
+
+    dacal::forward_list_hook *_ptr{};
+};
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Singly linked list threaded through a forward_list_hook member of T.
+ *  Keeps a tail pointer so both push_front and push_back are O(1); removal
+ *  in O(1) needs the predecessor, see erase_after().
+ **/
+template<class T, forward_list_hook T::*Hook>
+class [[maybe_unused]] intrusive_forward_list
+{
+public:
+    using value_type = T;
+    using reference = T &;
+    using iterator = detail::intrusive_forward_list_iterator<T, Hook>;
+
+    [[maybe_unused]] intrusive_forward_list() = default;
+    [[maybe_unused]] intrusive_forward_list(
+        const intrusive_forward_list &_other) = delete;
+    [[maybe_unused]] intrusive_forward_list(
+        intrusive_forward_list &&_other) noexcept;
+    [[maybe_unused]] ~intrusive_forward_list();
+
+    [[maybe_unused]] intrusive_forward_list &
+    operator=(const intrusive_forward_list &_other) = delete;
+    [[maybe_unused]] intrusive_forward_list &
+    operator=(intrusive_forward_list &&_other) noexcept;
+
+    [[maybe_unused]] iterator before_begin();
+    [[maybe_unused]] iterator begin();
+    [[maybe_unused]] iterator end();
+
+    [[maybe_unused]] iterator iterator_to(reference _data);
+
+    [[maybe_unused]] reference front();
+    [[maybe_unused]] reference back();
+
+    [[maybe_unused]] void push_back(reference _data);
+    [[maybe_unused]] void push_front(reference _data);
+    [[maybe_unused]] iterator insert_after(iterator _pos, reference _data);
+    [[maybe_unused]] iterator erase_after(iterator _pos);
+    [[maybe_unused]] void remove(reference _data);
+    [[maybe_unused]] reference pop_front();
+    [[maybe_unused]] void clear();
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] bool empty() const;
+
+private:
+    [[maybe_unused]] static forward_list_hook *_hook(reference _data);
+    [[maybe_unused]] void
+    _link_after(forward_list_hook *pos, forward_list_hook *hook);
+    [[maybe_unused]] void _unlink_after(forward_list_hook *pos);
+    [[maybe_unused]] void _take(intrusive_forward_list &_other);
+
+    // _root._successor is the first element, before_begin() points at it
+    forward_list_hook _root;
+    forward_list_hook *_list_tail{&_root};
+    std::size_t _size{};
+};
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] forward_list_hook *
+intrusive_forward_list<T, Hook>::_hook(reference _data)
+{
+    return detail::intrusive_hook<T, forward_list_hook, Hook>(_data);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void intrusive_forward_list<T, Hook>::_link_after(
+    forward_list_hook *pos, forward_list_hook *hook)
+{
+#if DACAL_INTRUSIVE_SAFE_MODE
+    assert(!hook->is_linked() && "object is already in a list");
+    hook->_linked = true;
+#endif
+    hook->_successor = pos->_successor;
+    pos->_successor = hook;
+    if (pos == _list_tail)
+        _list_tail = hook;
+    ++_size;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void
+intrusive_forward_list<T, Hook>::_unlink_after(forward_list_hook *pos)
+{
+    auto hook = pos->_successor;
+    pos->_successor = hook->_successor;
+    if (hook == _list_tail)
+        _list_tail = pos;
+#if DACAL_INTRUSIVE_SAFE_MODE
+    hook->_successor = nullptr;
+    hook->_linked = false;
+#endif
+    --_size;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void
+intrusive_forward_list<T, Hook>::_take(intrusive_forward_list &_other)
+{
+    _root._successor = dacal::exchange(_other._root._successor, nullptr);
+    _list_tail = _other._size == 0 ? &_root : _other._list_tail;
+    _size = dacal::exchange(_other._size, 0);
+    _other._list_tail = &_other._root;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] intrusive_forward_list<T, Hook>::intrusive_forward_list(
+    intrusive_forward_list &&_other) noexcept
+{
+    _take(_other);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] intrusive_forward_list<T, Hook>::~intrusive_forward_list()
+{
+    clear();
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] intrusive_forward_list<T, Hook> &
+intrusive_forward_list<T, Hook>::operator=(
+    intrusive_forward_list &&_other) noexcept
+{
+    if (this != &_other) {
+        clear();
+        _take(_other);
+    }
+    return *this;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::before_begin()
+{
+    return iterator(&_root);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::begin()
+{
+    return iterator(_root._successor);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::end()
+{
+    return iterator(nullptr);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::iterator_to(reference _data)
+{
+    return iterator(_hook(_data));
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::reference
+intrusive_forward_list<T, Hook>::front()
+{
+    return *begin();
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::reference
+intrusive_forward_list<T, Hook>::back()
+{
+    return *iterator(_list_tail);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void
+intrusive_forward_list<T, Hook>::push_back(reference _data)
+{
+    _link_after(_list_tail, _hook(_data));
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void
+intrusive_forward_list<T, Hook>::push_front(reference _data)
+{
+    _link_after(&_root, _hook(_data));
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::insert_after(iterator _pos, reference _data)
+{
+    _link_after(_pos._ptr, _hook(_data));
+    return iterator(_hook(_data));
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::iterator
+intrusive_forward_list<T, Hook>::erase_after(iterator _pos)
+{
+    _unlink_after(_pos._ptr);
+    return iterator(_pos._ptr->_successor);
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void intrusive_forward_list<T, Hook>::remove(reference _data)
+{
+    auto hook = _hook(_data);
+    for (auto i = &_root; i->_successor != nullptr; i = i->_successor) {
+        if (i->_successor == hook) {
+            _unlink_after(i);
+            return;
+        }
+    }
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_forward_list<T, Hook>::reference
+intrusive_forward_list<T, Hook>::pop_front()
+{
+    auto &ret_val = front();
+    _unlink_after(&_root);
+    return ret_val;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] void intrusive_forward_list<T, Hook>::clear()
+{
+#if DACAL_INTRUSIVE_SAFE_MODE
+    while (_size != 0) {
+        _unlink_after(&_root);
+    }
+#else
+    _size = 0;
+#endif
+    _root._successor = nullptr;
+    _list_tail = &_root;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] std::size_t
+intrusive_forward_list<T, Hook>::size() const
+{
+    return _size;
+}
+
+template<class T, forward_list_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] bool
+intrusive_forward_list<T, Hook>::empty() const
+{
+    return _size == 0;
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_INTRUSIVE_FORWARD_LIST_HPP
@@ -0,0 +1,450 @@
+#ifndef DACAL_INTRUSIVE_LIST_HPP
+#define DACAL_INTRUSIVE_LIST_HPP
+
+#include "iterator.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+
+// safe mode hooks null their links when unlinked, can tell whether they are
+// linked and assert on double insertion or on destruction while still
+// linked; on unless NDEBUG is defined, -DDACAL_INTRUSIVE_SAFE_MODE=0 or =1
+// overrides that
+#if !defined(DACAL_INTRUSIVE_SAFE_MODE)
+#if defined(NDEBUG)
+#define DACAL_INTRUSIVE_SAFE_MODE 0
+#else
+#define DACAL_INTRUSIVE_SAFE_MODE 1
+#endif
+#endif
+
+namespace dacal {
+struct [[maybe_unused]] list_hook
+{
+    [[maybe_unused]] list_hook() = default;
+
+    // an object copy is a new object, it is not linked anywhere
+    [[maybe_unused]] list_hook(const list_hook &) {}
+    [[maybe_unused]] list_hook &operator=(const list_hook &)
+    {
+        return *this;
+    }
+
+    [[maybe_unused]] ~list_hook()
+    {
+#if DACAL_INTRUSIVE_SAFE_MODE
+        assert(!is_linked() && "object destroyed while still in a list");
+#endif
+    }
+
+#if DACAL_INTRUSIVE_SAFE_MODE
+    // only safe mode clears the links of an unlinked hook
+    [[maybe_unused]] [[nodiscard]] bool is_linked() const
+    {
+        return _successor != nullptr;
+    }
+#endif
+
+    list_hook *_predecessor{};
+    list_hook *_successor{};
+};
+
+}  // namespace dacal
+
+namespace detail {
+// byte offset of the Hook member within T. It is measured on the real
+// objects handed to the containers, see intrusive_hook, and intrusive_owner
+// only ever gets hooks of such objects. Hook may not sit in a virtual base
+// of T, where the offset differs between objects
+template<class T, class HookType, HookType T::*Hook>
+inline std::atomic<std::ptrdiff_t> intrusive_hook_offset{-1};
+
+// the hook of an object a container is given, recording the hook offset.
+// Once it is known the store is skipped, so threads pushing to one queue do
+// not keep writing the same cache line; a push publishes the hook with
+// release semantics, which makes the offset visible to whoever pops it
+template<class T, class HookType, HookType T::*Hook>
+HookType *intrusive_hook(T &object)
+{
+    auto hook = &(object.*Hook);
+    auto offset =
+        reinterpret_cast<char *>(hook) - reinterpret_cast<char *>(&object);
+    auto &known = intrusive_hook_offset<T, HookType, Hook>;
+    if (known.load(std::memory_order_relaxed) != offset)
+        known.store(offset, std::memory_order_relaxed);
+    return hook;
+}
+
+// recovers the object that embeds `hook` as its `Hook` member
+template<class T, class HookType, HookType T::*Hook>
+T *intrusive_owner(HookType *hook)
+{
+    auto offset = intrusive_hook_offset<T, HookType, Hook>.load(
+        std::memory_order_relaxed);
+    return reinterpret_cast<T *>(reinterpret_cast<char *>(hook) - offset);
+}
+
+template<class T, dacal::list_hook T::*Hook>
+struct [[maybe_unused]] intrusive_list_iterator
+    : dacal::base_iterator<
+          dacal::bidirectional_iterator_tag,
+          T,
+          std::size_t,
+          T *,
+          T &>
+{
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::iterator_category;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::value_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::difference_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::pointer;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::reference;
+
+    [[maybe_unused]] explicit intrusive_list_iterator(dacal::list_hook *ptr) :
+        _ptr(ptr)
+    {}
+    [[maybe_unused]] intrusive_list_iterator() = default;
+
+    [[maybe_unused]] intrusive_list_iterator &operator--()
+    {
+        this->_ptr = this->_ptr->_predecessor;
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator--(int) -> intrusive_list_iterator
+    {
+        auto _temp = *this;
+        this->_ptr = this->_ptr->_predecessor;
+        return _temp;
+    }
+
+    [[maybe_unused]] intrusive_list_iterator &operator++()
+    {
+        this->_ptr = this->_ptr->_successor;
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator++(int) -> intrusive_list_iterator
+    {
+        auto _temp = *this;
+        this->_ptr = this->_ptr->_successor;
+        return _temp;
+    }
+
+    [[maybe_unused]] bool operator!=(const intrusive_list_iterator &i)
+    {
+        return this->_ptr != i._ptr;
+    }
+
+    [[maybe_unused]] reference operator*()
+    {
+        return *intrusive_owner<T, dacal::list_hook, Hook>(_ptr);
+    }
+
+    dacal::list_hook *_ptr{};
+};
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Doubly linked list threaded through a list_hook member of T. The list
+ *  never allocates or copies elements, it only links objects owned by the
+ *  caller; an element must be unlinked before it is destroyed.
+ **/
+template<class T, list_hook T::*Hook>
+class [[maybe_unused]] intrusive_list
+{
+public:
+    using value_type = T;
+    using reference = T &;
+    using iterator = detail::intrusive_list_iterator<T, Hook>;
+    using reverse_iterator = detail::container_reverse_iterator<iterator>;
+
+    [[maybe_unused]] intrusive_list();
+    [[maybe_unused]] intrusive_list(const intrusive_list &_other) = delete;
+    [[maybe_unused]] intrusive_list(intrusive_list &&_other) noexcept;
+    [[maybe_unused]] ~intrusive_list();
+
+    [[maybe_unused]] intrusive_list &
+    operator=(const intrusive_list &_other) = delete;
+    [[maybe_unused]] intrusive_list &
+    operator=(intrusive_list &&_other) noexcept;
+
+    [[maybe_unused]] iterator begin();
+    [[maybe_unused]] iterator end();
+
+    [[maybe_unused]] reverse_iterator rbegin();
+    [[maybe_unused]] reverse_iterator rend();
+
+    [[maybe_unused]] iterator iterator_to(reference _data);
+
+    [[maybe_unused]] reference front();
+    [[maybe_unused]] reference back();
+
+    [[maybe_unused]] void push_back(reference _data);
+    [[maybe_unused]] void push_front(reference _data);
+    [[maybe_unused]] iterator insert(iterator _pos, reference _data);
+    [[maybe_unused]] iterator erase(iterator _pos);
+    [[maybe_unused]] void remove(reference _data);
+    [[maybe_unused]] reference pop_back();
+    [[maybe_unused]] reference pop_front();
+    [[maybe_unused]] void clear();
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] bool empty() const;
+
+private:
+    [[maybe_unused]] static list_hook *_hook(reference _data);
+    [[maybe_unused]] void _link_before(list_hook *pos, list_hook *hook);
+    [[maybe_unused]] void _unlink(list_hook *hook);
+    [[maybe_unused]] void _take(intrusive_list &_other);
+
+    // circular sentinel, end() points at it so no operation needs a branch
+    // for the first or last element
+    list_hook _root;
+    std::size_t _size{};
+};
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] list_hook *intrusive_list<T, Hook>::_hook(reference _data)
+{
+    return detail::intrusive_hook<T, list_hook, Hook>(_data);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void
+intrusive_list<T, Hook>::_link_before(list_hook *pos, list_hook *hook)
+{
+#if DACAL_INTRUSIVE_SAFE_MODE
+    assert(!hook->is_linked() && "object is already in a list");
+#endif
+    hook->_successor = pos;
+    hook->_predecessor = pos->_predecessor;
+    pos->_predecessor->_successor = hook;
+    pos->_predecessor = hook;
+    ++_size;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::_unlink(list_hook *hook)
+{
+    hook->_predecessor->_successor = hook->_successor;
+    hook->_successor->_predecessor = hook->_predecessor;
+#if DACAL_INTRUSIVE_SAFE_MODE
+    hook->_predecessor = nullptr;
+    hook->_successor = nullptr;
+#endif
+    --_size;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::_take(intrusive_list &_other)
+{
+    if (_other._size == 0) {
+        _root._predecessor = _root._successor = &_root;
+        _size = 0;
+        return;
+    }
+
+    _root._successor = _other._root._successor;
+    _root._predecessor = _other._root._predecessor;
+    _root._successor->_predecessor = &_root;
+    _root._predecessor->_successor = &_root;
+    _size = dacal::exchange(_other._size, 0);
+    _other._root._predecessor = _other._root._successor = &_other._root;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] intrusive_list<T, Hook>::intrusive_list()
+{
+    _root._predecessor = _root._successor = &_root;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] intrusive_list<T, Hook>::intrusive_list(
+    intrusive_list &&_other) noexcept
+{
+    _take(_other);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] intrusive_list<T, Hook>::~intrusive_list()
+{
+    clear();
+#if DACAL_INTRUSIVE_SAFE_MODE
+    _root._predecessor = _root._successor = nullptr;
+#endif
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] intrusive_list<T, Hook> &
+intrusive_list<T, Hook>::operator=(intrusive_list &&_other) noexcept
+{
+    if (this != &_other) {
+        clear();
+        _take(_other);
+    }
+    return *this;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::begin()
+{
+    return iterator(_root._successor);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::end()
+{
+    return iterator(&_root);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reverse_iterator
+intrusive_list<T, Hook>::rbegin()
+{
+    return reverse_iterator(iterator(_root._predecessor));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reverse_iterator
+intrusive_list<T, Hook>::rend()
+{
+    return reverse_iterator(iterator(&_root));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::iterator_to(reference _data)
+{
+    return iterator(_hook(_data));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reference
+intrusive_list<T, Hook>::front()
+{
+    return *begin();
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reference
+intrusive_list<T, Hook>::back()
+{
+    return *iterator(_root._predecessor);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::push_back(reference _data)
+{
+    _link_before(&_root, _hook(_data));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::push_front(reference _data)
+{
+    _link_before(_root._successor, _hook(_data));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::insert(iterator _pos, reference _data)
+{
+    _link_before(_pos._ptr, _hook(_data));
+    return iterator(_hook(_data));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::erase(iterator _pos)
+{
+    auto successor = _pos._ptr->_successor;
+    _unlink(_pos._ptr);
+    return iterator(successor);
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::remove(reference _data)
+{
+    _unlink(_hook(_data));
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reference
+intrusive_list<T, Hook>::pop_back()
+{
+    auto &ret_val = back();
+    _unlink(_root._predecessor);
+    return ret_val;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] typename intrusive_list<T, Hook>::reference
+intrusive_list<T, Hook>::pop_front()
+{
+    auto &ret_val = front();
+    _unlink(_root._successor);
+    return ret_val;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] void intrusive_list<T, Hook>::clear()
+{
+#if DACAL_INTRUSIVE_SAFE_MODE
+    while (_size != 0) {
+        _unlink(_root._successor);
+    }
+#else
+    _size = 0;
+#endif
+    _root._predecessor = _root._successor = &_root;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] std::size_t intrusive_list<T, Hook>::size() const
+{
+    return _size;
+}
+
+template<class T, list_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] bool intrusive_list<T, Hook>::empty() const
+{
+    return _size == 0;
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_INTRUSIVE_LIST_HPP
@@ -4,6 +4,7 @@
 #include "utils.hpp"
 
 #include <concepts>
+#include <type_traits>
 
 namespace dacal {
 struct input_iterator_tag
@@ -16,6 +17,8 @@ struct bidirectional_iterator_tag : forward_iterator_tag
 {};
 struct random_access_iterator_tag : bidirectional_iterator_tag
 {};
+struct contiguous_iterator_tag : random_access_iterator_tag
+{};
 
 template<
     class Category,
@@ -51,9 +54,11 @@ concept InputIterator =
              };
          };
 
+// forward iterators count as well, their elements can be assigned to
 template<class T>
 concept OutputIterator =
-    std::derived_from<typename T::iterator_category, output_iterator_tag> &&
+    (std::derived_from<typename T::iterator_category, output_iterator_tag> ||
+     std::derived_from<typename T::iterator_category, forward_iterator_tag>) &&
     requires(T ptr) {
         {
             *ptr
@@ -115,6 +120,18 @@ concept RandomAccessIterator = BidirectionalIterator<T> &&
     std::derived_from<typename T::iterator_category,
                       random_access_iterator_tag>;
 
+// elements sit next to each other in memory and _ptr points at the current
+// one, so a range can be handed to memmove or a vector kernel as is
+template<class T>
+concept ContiguousIterator = RandomAccessIterator<T> &&
+    std::derived_from<typename T::iterator_category,
+                      contiguous_iterator_tag> &&
+    requires(T ptr) {
+        {
+            ptr._ptr
+        } -> std::same_as<typename T::pointer &>;
+    };
+
 template<class Container>
 struct [[maybe_unused]] insert_iterator
     : base_iterator<output_iterator_tag, void, std::size_t, void, void>
@@ -218,9 +235,18 @@ private:
 }  // namespace dacal
 
 namespace detail {
+// a reversed contiguous range is still random access, but no longer
+// contiguous
+template<class Iter>
+using reverse_iterator_category = std::conditional_t<
+    std::is_same_v<typename Iter::iterator_category,
+                   dacal::contiguous_iterator_tag>,
+    dacal::random_access_iterator_tag,
+    typename Iter::iterator_category>;
+
 template<class Iter>
 struct container_reverse_iterator : dacal::base_iterator<
-                                        typename Iter::iterator_category,
+                                        reverse_iterator_category<Iter>,
                                         typename Iter::value_type,
                                         typename Iter::difference_type,
                                         typename Iter::pointer,
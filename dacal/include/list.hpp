@@ -2,6 +2,8 @@
 #define DACAL_LIST_HPP
 
 #include "iterator.hpp"
+#include "memory_resource.hpp"
+#include "merge_sort.hpp"
 #include "utils.hpp"
 
 #include <initializer_list>
@@ -213,6 +215,7 @@ public:
         allocator>::template rebind_alloc<detail::list_node<T>>;
 
     [[maybe_unused]] list() = default;
+    [[maybe_unused]] explicit list(const allocator &_alloc);
     [[maybe_unused]] list(const list<T, Allocator> &_other);
     [[maybe_unused]] list(list<T, Allocator> &&_other) noexcept;
     [[maybe_unused]] list(const std::initializer_list<T> &initializer);
@@ -236,38 +239,126 @@ public:
     [[maybe_unused]] const_reverse_iterator crend() const;
 
     [[maybe_unused]] void push_back(const_reference _data);
+    [[maybe_unused]] void push_front(const_reference _data);
+    [[maybe_unused]] iterator insert(iterator _pos, const_reference _data);
+    [[maybe_unused]] iterator erase(iterator _pos);
     [[maybe_unused]] void remove(const_reference &_data);
     [[maybe_unused]] [[nodiscard]] value_type pop_back();
     [[maybe_unused]] [[nodiscard]] value_type pop_front();
 
+    [[maybe_unused]] void splice(iterator _pos, list<T, Allocator> &_other);
+    [[maybe_unused]] void
+    splice(iterator _pos, list<T, Allocator> &_other, iterator _it);
+    [[maybe_unused]] void splice(
+        iterator _pos,
+        list<T, Allocator> &_other,
+        iterator _first,
+        iterator _last);
+
+    template<class Compare = dacal::less<T>>
+    [[maybe_unused]] void sort(const Compare &_compare = Compare{});
+    template<class Compare = dacal::less<T>>
+    [[maybe_unused]] void
+    merge(list<T, Allocator> &_other, const Compare &_compare = Compare{});
+    [[maybe_unused]] std::size_t unique();
+    template<class BinaryPredicate>
+    [[maybe_unused]] std::size_t unique(const BinaryPredicate &_predicate);
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] bool empty() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
+
 private:
     [[maybe_unused]] void _push_back(const T &data);
     [[maybe_unused]] void _destroy();
+    [[maybe_unused]] detail::list_node<T> *_create_node(const T &data);
+    [[maybe_unused]] void _destroy_node(detail::list_node<T> *node);
+    [[maybe_unused]] void
+    _link_before(detail::list_node<T> *pos, detail::list_node<T> *node);
+    [[maybe_unused]] void _unlink(detail::list_node<T> *node);
+    [[maybe_unused]] void _relink_predecessors();
 
     allocator _allocator;
     node_allocator _node_allocator;
     detail::list_node<T> *_list_head{}, *_list_tail{};
+    std::size_t _size{};
 };
 
 template<class T, class Allocator>
-[[maybe_unused]] void list<T, Allocator>::_push_back(const T &data)
+[[maybe_unused]] detail::list_node<T> *
+list<T, Allocator>::_create_node(const T &data)
 {
-    if (_list_head == nullptr) {
-        _list_head =
-            std::allocator_traits<node_allocator>::allocate(_node_allocator, 1);
-        std::allocator_traits<allocator>::construct(
-            _allocator, _list_head, data, nullptr, nullptr);
-    }
-    else {
-        detail::list_node<T> *i;
-        for (i = _list_head; i->_successor != nullptr; i = i->_successor)
-            ;
-        i->_successor =
-            std::allocator_traits<node_allocator>::allocate(_node_allocator, 1);
-        std::allocator_traits<allocator>::construct(
-            _allocator, i->_successor, data, i, nullptr);
-        _list_tail = i->_successor;
+    auto node =
+        std::allocator_traits<node_allocator>::allocate(_node_allocator, 1);
+    std::allocator_traits<allocator>::construct(
+        _allocator, node, data, nullptr, nullptr);
+    return node;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void
+list<T, Allocator>::_destroy_node(detail::list_node<T> *node)
+{
+    std::allocator_traits<allocator>::destroy(_allocator, node);
+    std::allocator_traits<node_allocator>::deallocate(_node_allocator, node, 1);
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::_link_before(
+    detail::list_node<T> *pos, detail::list_node<T> *node)
+{
+    // a null position is end(), linking before it appends
+    node->_successor = pos;
+    node->_predecessor = pos ? pos->_predecessor : _list_tail;
+
+    if (node->_predecessor)
+        node->_predecessor->_successor = node;
+    else
+        _list_head = node;
+
+    if (pos)
+        pos->_predecessor = node;
+    else
+        _list_tail = node;
+
+    ++_size;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::_unlink(detail::list_node<T> *node)
+{
+    if (node->_predecessor)
+        node->_predecessor->_successor = node->_successor;
+    else
+        _list_head = node->_successor;
+
+    if (node->_successor)
+        node->_successor->_predecessor = node->_predecessor;
+    else
+        _list_tail = node->_predecessor;
+
+    node->_predecessor = nullptr;
+    node->_successor = nullptr;
+    --_size;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::_relink_predecessors()
+{
+    // the sorting helpers only maintain _successor links
+    detail::list_node<T> *predecessor = nullptr;
+    for (auto i = _list_head; i != nullptr; i = i->_successor) {
+        i->_predecessor = predecessor;
+        predecessor = i;
     }
+    _list_tail = predecessor;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::_push_back(const T &data)
+{
+    _link_before(nullptr, _create_node(data));
 }
 
 template<class T, class Allocator>
@@ -276,14 +367,24 @@ template<class T, class Allocator>
     for (auto i = _list_head; i != nullptr;) {
         auto temp = i;
         i = i->_successor;
-        std::allocator_traits<allocator>::destroy(_allocator, temp);
-        std::allocator_traits<node_allocator>::deallocate(
-            _node_allocator, temp, 1);
+        _destroy_node(temp);
     }
+    _list_head = _list_tail = nullptr;
+    _size = 0;
 }
 
 template<class T, class Allocator>
-[[maybe_unused]] list<T, Allocator>::list(const list<T, Allocator> &_other)
+[[maybe_unused]] list<T, Allocator>::list(const allocator &_alloc) :
+    _allocator(_alloc),
+    _node_allocator(_alloc)
+{}
+
+template<class T, class Allocator>
+[[maybe_unused]] list<T, Allocator>::list(const list<T, Allocator> &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator)),
+    _node_allocator(_allocator)
 {
     for (auto i = _other._list_head; i != nullptr; i = i->_successor) {
         _push_back(i->_data);
@@ -291,10 +392,14 @@ template<class T, class Allocator>
 }
 
 template<class T, class Allocator>
-[[maybe_unused]] list<T, Allocator>::list(list<T, Allocator> &&_other) noexcept
+[[maybe_unused]] list<T, Allocator>::list(
+    list<T, Allocator> &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator)),
+    _node_allocator(dacal::move(_other._node_allocator))
 {
     this->_list_head = exchange(_other._list_head, nullptr);
     this->_list_tail = exchange(_other._list_tail, nullptr);
+    this->_size = exchange(_other._size, 0);
 }
 
 template<class T, class Allocator>
@@ -318,6 +423,7 @@ template<class T, class Allocator>
 list<T, Allocator>::operator=(const list<T, Allocator> &_other)
 {
     if (this != &_other) {  // avoid self assigment
+        _destroy();
         for (auto i = _other._list_head; i != nullptr; i = i->_successor) {
             _push_back(i->_data);
         }
@@ -329,8 +435,16 @@ template<class T, class Allocator>
 [[maybe_unused]] list<T, Allocator> &
 list<T, Allocator>::operator=(list<T, Allocator> &&_other) noexcept
 {
-    this->_list_head = exchange(_other._list_head, nullptr);
-    this->_list_tail = exchange(_other._list_tail, nullptr);
+    if (this != &_other) {
+        _destroy();
+
+        // the nodes can only be released by the allocator that made them
+        _allocator = _other._allocator;
+        _node_allocator = _other._node_allocator;
+        this->_list_head = exchange(_other._list_head, nullptr);
+        this->_list_tail = exchange(_other._list_tail, nullptr);
+        this->_size = exchange(_other._size, 0);
+    }
     return *this;
 }
 
@@ -397,6 +511,31 @@ template<class T, class Allocator>
     _push_back(_data);
 }
 
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::push_front(const_reference _data)
+{
+    _link_before(_list_head, _create_node(_data));
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] typename list<T, Allocator>::iterator
+list<T, Allocator>::insert(iterator _pos, const_reference _data)
+{
+    auto node = _create_node(_data);
+    _link_before(_pos._ptr, node);
+    return iterator(node);
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] typename list<T, Allocator>::iterator
+list<T, Allocator>::erase(iterator _pos)
+{
+    auto successor = _pos._ptr->_successor;
+    _unlink(_pos._ptr);
+    _destroy_node(_pos._ptr);
+    return iterator(successor);
+}
+
 template<class T, class Allocator>
 [[maybe_unused]] void
 list<T, Allocator>::remove(typename list<T, Allocator>::const_reference _data)
@@ -409,44 +548,8 @@ list<T, Allocator>::remove(typename list<T, Allocator>::const_reference _data)
     }
 
     if (_node_to_delete) {
-        if (_node_to_delete->_predecessor != nullptr &&
-            _node_to_delete->_successor != nullptr) {
-            auto predecessor = _node_to_delete->_predecessor;
-            auto successor = _node_to_delete->_successor;
-            predecessor->_successor = successor;
-            successor->_predecessor = predecessor;
-            std::allocator_traits<allocator>::destroy(
-                _allocator, _node_to_delete);
-            std::allocator_traits<node_allocator>::deallocate(
-                _node_allocator, _node_to_delete, 1);
-        }
-        else if (
-            _node_to_delete->_predecessor == nullptr &&
-            _node_to_delete->_successor != nullptr) {
-            auto successor = _node_to_delete->_successor;
-            std::allocator_traits<allocator>::destroy(
-                _allocator, _node_to_delete);
-            std::allocator_traits<node_allocator>::deallocate(
-                _node_allocator, _node_to_delete, 1);
-            successor->_predecessor = nullptr;
-            _list_head = successor;
-        }
-        else if (
-            _node_to_delete->_predecessor != nullptr &&
-            _node_to_delete->_successor == nullptr) {
-            auto predecessor = _node_to_delete->_predecessor;
-            std::allocator_traits<allocator>::destroy(
-                _allocator, _node_to_delete);
-            std::allocator_traits<node_allocator>::deallocate(
-                _node_allocator, _node_to_delete, 1);
-            predecessor->_successor = nullptr;
-        }
-        else {
-            std::allocator_traits<allocator>::destroy(_allocator, _list_head);
-            std::allocator_traits<node_allocator>::deallocate(
-                _node_allocator, _list_head, 1);
-            _list_head = nullptr;
-        }
+        _unlink(_node_to_delete);
+        _destroy_node(_node_to_delete);
     }
 }
 
@@ -456,15 +559,8 @@ list<T, Allocator>::pop_back()
 {
     auto ret_val_ = _list_tail->_data;
     auto temp = _list_tail;
-    _list_tail = _list_tail->_predecessor;
-
-    if (_list_tail)
-        _list_tail->_successor = nullptr;
-    else
-        _list_head = nullptr;
-
-    std::allocator_traits<allocator>::destroy(_allocator, temp);
-    std::allocator_traits<node_allocator>::deallocate(_node_allocator, temp, 1);
+    _unlink(temp);
+    _destroy_node(temp);
     return ret_val_;
 }
 
@@ -472,28 +568,146 @@ template<class T, class Allocator>
 [[maybe_unused]] [[nodiscard]] typename list<T, Allocator>::value_type
 list<T, Allocator>::pop_front()
 {
-    if (_list_head->_successor == nullptr) {
-        auto ret_val = _list_head->_data;
-        std::allocator_traits<allocator>::destroy(_allocator, _list_head);
-        std::allocator_traits<node_allocator>::deallocate(
-            _node_allocator, _list_head, 1);
-        _list_head = nullptr;
-        return ret_val;
+    auto ret_val = _list_head->_data;
+    auto temp = _list_head;
+    _unlink(temp);
+    _destroy_node(temp);
+    return ret_val;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void
+list<T, Allocator>::splice(iterator _pos, list<T, Allocator> &_other)
+{
+    if (this == &_other || _other._list_head == nullptr)
+        return;
+
+    auto first = _other._list_head;
+    auto last = _other._list_tail;
+    auto pos = _pos._ptr;
+
+    first->_predecessor = pos ? pos->_predecessor : _list_tail;
+    last->_successor = pos;
+
+    if (first->_predecessor)
+        first->_predecessor->_successor = first;
+    else
+        _list_head = first;
+
+    if (pos)
+        pos->_predecessor = last;
+    else
+        _list_tail = last;
+
+    _size += _other._size;
+    _other._list_head = _other._list_tail = nullptr;
+    _other._size = 0;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::splice(
+    iterator _pos, list<T, Allocator> &_other, iterator _it)
+{
+    if (_pos._ptr == _it._ptr)
+        return;
+
+    _other._unlink(_it._ptr);
+    _link_before(_pos._ptr, _it._ptr);
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] void list<T, Allocator>::splice(
+    iterator _pos, list<T, Allocator> &_other, iterator _first, iterator _last)
+{
+    while (_first != _last) {
+        splice(_pos, _other, _first++);
     }
-    else {
-        auto ret_val = _list_head->_data;
-        auto t = _list_head->_successor;
+}
+
+template<class T, class Allocator>
+template<class Compare>
+[[maybe_unused]] void list<T, Allocator>::sort(const Compare &_compare)
+{
+    _list_head = detail::merge_sort_nodes(_list_head, _compare);
+    _relink_predecessors();
+}
 
-        std::allocator_traits<allocator>::destroy(_allocator, t->_predecessor);
-        std::allocator_traits<node_allocator>::deallocate(
-            _node_allocator, t->_predecessor, 1);
-        t->_predecessor = nullptr;
+template<class T, class Allocator>
+template<class Compare>
+[[maybe_unused]] void
+list<T, Allocator>::merge(list<T, Allocator> &_other, const Compare &_compare)
+{
+    if (this == &_other)
+        return;
 
-        _list_head = t;
-        return ret_val;
+    _list_head = detail::merge_nodes(_list_head, _other._list_head, _compare);
+    _relink_predecessors();
+
+    _size += _other._size;
+    _other._list_head = _other._list_tail = nullptr;
+    _other._size = 0;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] std::size_t list<T, Allocator>::unique()
+{
+    return unique([](const T &_lhs, const T &_rhs) { return _lhs == _rhs; });
+}
+
+template<class T, class Allocator>
+template<class BinaryPredicate>
+[[maybe_unused]] std::size_t
+list<T, Allocator>::unique(const BinaryPredicate &_predicate)
+{
+    std::size_t _removed = 0;
+    for (auto i = _list_head; i != nullptr && i->_successor != nullptr;) {
+        auto successor = i->_successor;
+        if (_predicate(i->_data, successor->_data)) {
+            _unlink(successor);
+            _destroy_node(successor);
+            ++_removed;
+        }
+        else {
+            i = successor;
+        }
     }
+    return _removed;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t list<T, Allocator>::size() const
+{
+    return _size;
 }
 
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] bool list<T, Allocator>::empty() const
+{
+    return _size == 0;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename list<T, Allocator>::allocator
+list<T, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+list<T, Allocator>::memory_usage() const
+{
+    return {
+        _size * sizeof(T),
+        _size * (sizeof(detail::list_node<T>) - sizeof(T)) + sizeof(*this)};
+}
+
+namespace pmr {
+template<class T>
+using list = dacal::list<T, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace dacal
 
 #endif  // DACAL_LIST_HPP
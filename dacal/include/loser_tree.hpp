@@ -0,0 +1,121 @@
+#ifndef DACAL_LOSER_TREE_HPP
+#define DACAL_LOSER_TREE_HPP
+
+#include "utils.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace detail {
+/*
+ *  Tournament over the heads of k sorted sources. Every inner node keeps
+ *  the loser of the match played there and the overall winner sits at the
+ *  top, so once the winner's source moves on to its next element only the
+ *  matches on its path to the root are replayed: log k comparisons per
+ *  element against k - 1 for a scan and 2 log k for a heap. Nodes hold
+ *  source indices only, compare(i, j) tells whether the head of source i
+ *  is less than the head of source j, so heads are never copied.
+ *
+ *  On equal heads the source with the lower index wins, which keeps a
+ *  merge stable. An exhausted source loses against every other one.
+ **/
+template<class Compare>
+class loser_tree
+{
+public:
+    loser_tree(std::size_t _count, const Compare &_less);
+
+    // marks a source as having no head left, every empty source before
+    // build() and the winner before replay() once it runs out
+    void exhaust(std::size_t _source);
+    void build();
+
+    // whether every source is exhausted
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::size_t winner() const;
+    // replays the matches of the winner after its head moved on
+    void replay();
+
+private:
+    [[nodiscard]] bool _beats(std::size_t _lhs, std::size_t _rhs) const;
+
+    Compare _compare;
+    std::size_t _sources;
+    // the leaf of source i is node _sources + i and the parent of node n is
+    // n / 2; inner nodes hold the loser of their match, node 0 the winner
+    std::unique_ptr<std::size_t[]> _tree;
+    std::unique_ptr<bool[]> _done;
+};
+
+template<class Compare>
+loser_tree<Compare>::loser_tree(std::size_t _count, const Compare &_less) :
+    _compare(_less),
+    _sources(_count),
+    _tree(new std::size_t[_count]),
+    _done(new bool[_count]())
+{}
+
+template<class Compare>
+void loser_tree<Compare>::exhaust(std::size_t _source)
+{
+    _done[_source] = true;
+}
+
+template<class Compare>
+void loser_tree<Compare>::build()
+{
+    if (_sources == 0)
+        return;
+
+    // winners of the matches below each inner node, leaves included
+    std::unique_ptr<std::size_t[]> _winners(new std::size_t[2 * _sources]);
+    for (std::size_t i = 0; i < _sources; ++i)
+        _winners[_sources + i] = i;
+    for (auto n = _sources - 1; n > 0; --n) {
+        auto _left = _winners[2 * n], _right = _winners[2 * n + 1];
+        if (_beats(_right, _left))
+            dacal::swap(_left, _right);
+        _winners[n] = _left;
+        _tree[n] = _right;
+    }
+    _tree[0] = _winners[1];
+}
+
+template<class Compare>
+[[nodiscard]] bool loser_tree<Compare>::empty() const
+{
+    return _sources == 0 || _done[_tree[0]];
+}
+
+template<class Compare>
+[[nodiscard]] std::size_t loser_tree<Compare>::winner() const
+{
+    return _tree[0];
+}
+
+template<class Compare>
+void loser_tree<Compare>::replay()
+{
+    auto _winner = _tree[0];
+    for (auto n = (_sources + _winner) / 2; n > 0; n /= 2) {
+        if (_beats(_tree[n], _winner))
+            dacal::swap(_tree[n], _winner);
+    }
+    _tree[0] = _winner;
+}
+
+template<class Compare>
+[[nodiscard]] bool
+loser_tree<Compare>::_beats(std::size_t _lhs, std::size_t _rhs) const
+{
+    if (_done[_lhs] || _done[_rhs])
+        return !_done[_lhs];
+    // the earlier source loses only to a strictly smaller head
+    if (_lhs < _rhs)
+        return !_compare(_rhs, _lhs);
+    return _compare(_lhs, _rhs);
+}
+
+}  // namespace detail
+
+#endif  // DACAL_LOSER_TREE_HPP
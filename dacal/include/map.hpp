@@ -2,6 +2,7 @@
 #define DACAL_MAP_HPP
 
 #include "iterator.hpp"
+#include "memory_resource.hpp"
 #include "pair.hpp"
 #include "utils.hpp"
 
@@ -28,6 +29,7 @@ public:
         allocator>::template rebind_alloc<detail::rb_tree_node<value_type>>;
 
     [[maybe_unused]] map() = default;
+    [[maybe_unused]] explicit map(const allocator &_alloc);
     [[maybe_unused]] map(const std::initializer_list<value_type> &_initializer);
     [[maybe_unused]] map(const map &_other);
     [[maybe_unused]] map(map &&_other) noexcept;
@@ -46,6 +48,9 @@ public:
     [[maybe_unused]] value_type &insert(value_type _data);
     [[maybe_unused]] iterator find(const key_type &key);
 
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
+
 private:
     [[maybe_unused]] void _insert(
         detail::rb_tree_node<value_type> *&_node,
@@ -55,6 +60,7 @@ private:
     void _fix_insert(detail::rb_tree_node<value_type> *node);
     [[maybe_unused]] void _rotateRight(detail::rb_tree_node<value_type> *node);
     [[maybe_unused]] void _rotateLeft(detail::rb_tree_node<value_type> *node);
+    [[maybe_unused]] void _destroy(detail::rb_tree_node<value_type> *node);
 
     allocator _allocator;
     node_allocator _node_allocator;
@@ -221,7 +227,17 @@ template<class Key, class T, class Compare, class Allocator>
 }
 
 template<class Key, class T, class Compare, class Allocator>
-[[maybe_unused]] map<Key, T, Compare, Allocator>::map(const map &_other)
+[[maybe_unused]] map<Key, T, Compare, Allocator>::map(const allocator &_alloc) :
+    _allocator(_alloc),
+    _node_allocator(_alloc)
+{}
+
+template<class Key, class T, class Compare, class Allocator>
+[[maybe_unused]] map<Key, T, Compare, Allocator>::map(const map &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator)),
+    _node_allocator(_allocator)
 {
     for (map<Key, T, Compare, Allocator>::iterator i = _other.begin();
          i != _other.end();
@@ -231,16 +247,30 @@ template<class Key, class T, class Compare, class Allocator>
 }
 
 template<class Key, class T, class Compare, class Allocator>
-[[maybe_unused]] map<Key, T, Compare, Allocator>::map(map &&_other) noexcept
+[[maybe_unused]] map<Key, T, Compare, Allocator>::map(map &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator)),
+    _node_allocator(dacal::move(_other._node_allocator))
 {
     this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
 }
 
+template<class Key, class T, class Compare, class Allocator>
+[[maybe_unused]] void map<Key, T, Compare, Allocator>::_destroy(
+    detail::rb_tree_node<value_type> *node)
+{
+    if (node == nullptr)
+        return;
+
+    _destroy(node->_left_child);
+    _destroy(node->_right_child);
+    std::allocator_traits<node_allocator>::destroy(_node_allocator, node);
+    std::allocator_traits<node_allocator>::deallocate(_node_allocator, node, 1);
+}
+
 template<class Key, class T, class Compare, class Allocator>
 [[maybe_unused]] map<Key, T, Compare, Allocator>::~map()
 {
-    std::allocator_traits<node_allocator>::deallocate(
-        _node_allocator, _root_of_tree, 1);
+    _destroy(_root_of_tree);
 }
 
 template<class Key, class T, class Compare, class Allocator>
@@ -248,6 +278,8 @@ template<class Key, class T, class Compare, class Allocator>
 map<Key, T, Compare, Allocator>::operator=(const map &_other)
 {
     if (this != &_other) {
+        _destroy(_root_of_tree);
+        _root_of_tree = nullptr;
         for (map<Key, T, Compare, Allocator>::iterator i = _other.begin();
              i != _other.end();
              ++i) {
@@ -261,7 +293,14 @@ template<class Key, class T, class Compare, class Allocator>
 [[maybe_unused]] map<Key, T, Compare, Allocator> &
 map<Key, T, Compare, Allocator>::operator=(map &&_other) noexcept
 {
-    this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
+    if (this != &_other) {
+        _destroy(_root_of_tree);
+
+        // the nodes can only be released by the allocator that made them
+        _allocator = _other._allocator;
+        _node_allocator = _other._node_allocator;
+        this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
+    }
     return *this;
 }
 
@@ -336,6 +375,37 @@ map<Key, T, Compare, Allocator>::find(const key_type &key)
     return end();
 }
 
+template<class Key, class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename map<
+    Key, T, Compare, Allocator>::allocator
+map<Key, T, Compare, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<class Key, class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+map<Key, T, Compare, Allocator>::memory_usage() const
+{
+    std::size_t _count = 0;
+    for (auto i = begin(); i != end(); ++i) {
+        ++_count;
+    }
+
+    return {
+        _count * sizeof(value_type),
+        _count * (sizeof(detail::rb_tree_node<value_type>) -
+                  sizeof(value_type)) +
+            sizeof(*this)};
+}
+
+namespace pmr {
+template<class Key, class T, class Compare = dacal::less<Key>>
+using map = dacal::
+    map<Key, T, Compare, polymorphic_allocator<dacal::pair<Key, T>>>;
+
+}  // namespace pmr
+
 }  // namespace dacal
 
 #endif  // DACAL_MAP_HPP
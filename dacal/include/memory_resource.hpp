@@ -0,0 +1,375 @@
+#ifndef DACAL_MEMORY_RESOURCE_HPP
+#define DACAL_MEMORY_RESOURCE_HPP
+
+#include "arena.hpp"
+#include "pool_allocator.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+namespace dacal {
+/*
+ *  Runtime chosen allocation strategy. Containers using
+ *  polymorphic_allocator share one type whatever resource backs them.
+ **/
+class [[maybe_unused]] memory_resource
+{
+public:
+    virtual ~memory_resource() = default;
+
+    [[maybe_unused]] [[nodiscard]] void *allocate(
+        std::size_t _bytes,
+        std::size_t _alignment = alignof(std::max_align_t))
+    {
+        return do_allocate(_bytes, _alignment);
+    }
+
+    [[maybe_unused]] void deallocate(
+        void *_ptr,
+        std::size_t _bytes,
+        std::size_t _alignment = alignof(std::max_align_t))
+    {
+        do_deallocate(_ptr, _bytes, _alignment);
+    }
+
+    [[maybe_unused]] [[nodiscard]] bool
+    is_equal(const memory_resource &_other) const noexcept
+    {
+        return this == &_other || do_is_equal(_other);
+    }
+
+private:
+    virtual void *do_allocate(std::size_t _bytes, std::size_t _alignment) = 0;
+    virtual void
+    do_deallocate(void *_ptr, std::size_t _bytes, std::size_t _alignment) = 0;
+    virtual bool do_is_equal(const memory_resource &_other) const noexcept = 0;
+};
+
+[[maybe_unused]] inline bool
+operator==(const memory_resource &_lhs, const memory_resource &_rhs) noexcept
+{
+    return _lhs.is_equal(_rhs);
+}
+
+[[maybe_unused]] inline bool
+operator!=(const memory_resource &_lhs, const memory_resource &_rhs) noexcept
+{
+    return !_lhs.is_equal(_rhs);
+}
+
+}  // namespace dacal
+
+namespace detail {
+class new_delete_memory_resource : public dacal::memory_resource
+{
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    void do_deallocate(
+        void *ptr,
+        [[maybe_unused]] std::size_t bytes,
+        std::size_t alignment) override
+    {
+        ::operator delete(ptr, std::align_val_t(alignment));
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+[[maybe_unused]] inline std::atomic<dacal::memory_resource *> &
+default_memory_resource();
+
+}  // namespace detail
+
+namespace dacal {
+[[maybe_unused]] inline memory_resource *new_delete_resource() noexcept
+{
+    static detail::new_delete_memory_resource resource;
+    return &resource;
+}
+
+[[maybe_unused]] inline memory_resource *get_default_resource() noexcept
+{
+    return detail::default_memory_resource().load(std::memory_order_acquire);
+}
+
+[[maybe_unused]] inline memory_resource *
+set_default_resource(memory_resource *_resource) noexcept
+{
+    if (_resource == nullptr)
+        _resource = new_delete_resource();
+    return detail::default_memory_resource().exchange(
+        _resource, std::memory_order_acq_rel);
+}
+
+/*
+ *  Bump allocation on top of dacal::arena, release() frees everything.
+ **/
+class [[maybe_unused]] monotonic_buffer_resource : public memory_resource
+{
+public:
+    [[maybe_unused]] explicit monotonic_buffer_resource(
+        std::size_t _initial_chunk_size = 4096) :
+        _arena(_initial_chunk_size)
+    {}
+
+    [[maybe_unused]] void release() noexcept
+    {
+        _arena.reset();
+    }
+
+private:
+    void *do_allocate(std::size_t _bytes, std::size_t _alignment) override
+    {
+        return _arena.allocate(_bytes, _alignment);
+    }
+
+    void do_deallocate(
+        [[maybe_unused]] void *_ptr,
+        [[maybe_unused]] std::size_t _bytes,
+        [[maybe_unused]] std::size_t _alignment) override
+    {}
+
+    bool do_is_equal(const memory_resource &_other) const noexcept override
+    {
+        return this == &_other;
+    }
+
+    arena _arena;
+};
+
+/*
+ *  Size classed free lists carved from spans of an upstream resource, the
+ *  same classes pool_allocator uses. Not thread safe; large or over
+ *  aligned blocks go to upstream directly.
+ **/
+class [[maybe_unused]] unsynchronized_pool_resource : public memory_resource
+{
+public:
+    [[maybe_unused]] explicit unsynchronized_pool_resource(
+        memory_resource *_parent = get_default_resource()) :
+        _upstream(_parent)
+    {}
+    [[maybe_unused]] unsynchronized_pool_resource(
+        const unsynchronized_pool_resource &_other) = delete;
+    [[maybe_unused]] ~unsynchronized_pool_resource() override
+    {
+        release();
+    }
+
+    [[maybe_unused]] unsynchronized_pool_resource &
+    operator=(const unsynchronized_pool_resource &_other) = delete;
+
+    [[maybe_unused]] void release()
+    {
+        while (_spans != nullptr) {
+            auto _span = _spans;
+            _spans = _span->_successor;
+            _upstream->deallocate(_span, detail::pool_span_bytes);
+        }
+        for (auto &_free : _bins)
+            _free = nullptr;
+    }
+
+    [[maybe_unused]] [[nodiscard]] memory_resource *upstream_resource() const
+    {
+        return _upstream;
+    }
+
+private:
+    static bool _is_pooled(std::size_t _bytes, std::size_t _alignment)
+    {
+        return _bytes <= detail::pool_max_block && _alignment <= 16;
+    }
+
+    void *do_allocate(std::size_t _bytes, std::size_t _alignment) override
+    {
+        if (!_is_pooled(_bytes, _alignment))
+            return _upstream->allocate(_bytes, _alignment);
+
+        auto _index = detail::pool_size_class(_bytes);
+        if (_bins[_index] == nullptr)
+            _carve(_index);
+
+        auto _block = _bins[_index];
+        _bins[_index] = _block->_successor;
+        return _block;
+    }
+
+    void do_deallocate(
+        void *_ptr, std::size_t _bytes, std::size_t _alignment) override
+    {
+        if (_ptr == nullptr)
+            return;
+        if (!_is_pooled(_bytes, _alignment)) {
+            _upstream->deallocate(_ptr, _bytes, _alignment);
+            return;
+        }
+
+        auto _index = detail::pool_size_class(_bytes);
+        auto _block = static_cast<detail::pool_block *>(_ptr);
+        _block->_successor = _bins[_index];
+        _bins[_index] = _block;
+    }
+
+    bool do_is_equal(const memory_resource &_other) const noexcept override
+    {
+        return this == &_other;
+    }
+
+    void _carve(std::size_t _index)
+    {
+        // the first block of every span links the span list, so a span
+        // holds one block less than it could
+        auto _size = detail::pool_block_size(_index);
+        auto _span = static_cast<char *>(
+            _upstream->allocate(detail::pool_span_bytes));
+        auto _header = reinterpret_cast<detail::pool_block *>(_span);
+        _header->_successor = _spans;
+        _spans = _header;
+
+        detail::pool_block *_head = nullptr;
+        for (auto offset = detail::pool_span_bytes / _size * _size;
+             offset != _size;) {
+            offset -= _size;
+            auto _block =
+                reinterpret_cast<detail::pool_block *>(_span + offset);
+            _block->_successor = _head;
+            _head = _block;
+        }
+        _bins[_index] = _head;
+    }
+
+    memory_resource *_upstream;
+    detail::pool_block *_spans{};
+    detail::pool_block *_bins[detail::pool_class_count]{};
+};
+
+class [[maybe_unused]] synchronized_pool_resource : public memory_resource
+{
+public:
+    [[maybe_unused]] explicit synchronized_pool_resource(
+        memory_resource *_upstream = get_default_resource()) :
+        _pool(_upstream)
+    {}
+
+    [[maybe_unused]] void release()
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _pool.release();
+    }
+
+    [[maybe_unused]] [[nodiscard]] memory_resource *upstream_resource() const
+    {
+        return _pool.upstream_resource();
+    }
+
+private:
+    void *do_allocate(std::size_t _bytes, std::size_t _alignment) override
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _pool.allocate(_bytes, _alignment);
+    }
+
+    void do_deallocate(
+        void *_ptr, std::size_t _bytes, std::size_t _alignment) override
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _pool.deallocate(_ptr, _bytes, _alignment);
+    }
+
+    bool do_is_equal(const memory_resource &_other) const noexcept override
+    {
+        return this == &_other;
+    }
+
+    std::mutex _mutex;
+    unsynchronized_pool_resource _pool;
+};
+
+template<class T>
+class [[maybe_unused]] polymorphic_allocator
+{
+public:
+    using value_type = T;
+
+    [[maybe_unused]] polymorphic_allocator() noexcept :
+        _resource(get_default_resource())
+    {}
+
+    [[maybe_unused]] polymorphic_allocator(
+        memory_resource *_memory) noexcept :
+        _resource(_memory)
+    {}
+
+    template<class U>
+    [[maybe_unused]] polymorphic_allocator(
+        const polymorphic_allocator<U> &_other) noexcept :
+        _resource(_other.resource())
+    {}
+
+    [[maybe_unused]] [[nodiscard]] T *allocate(std::size_t _n)
+    {
+        return static_cast<T *>(
+            _resource->allocate(_n * sizeof(T), alignof(T)));
+    }
+
+    [[maybe_unused]] void deallocate(T *_ptr, std::size_t _n)
+    {
+        // containers release their empty state without checking for null
+        if (_ptr != nullptr)
+            _resource->deallocate(_ptr, _n * sizeof(T), alignof(T));
+    }
+
+    // a copied container does not inherit its source's resource
+    [[maybe_unused]] polymorphic_allocator
+    select_on_container_copy_construction() const
+    {
+        return polymorphic_allocator();
+    }
+
+    [[maybe_unused]] [[nodiscard]] memory_resource *resource() const
+    {
+        return _resource;
+    }
+
+    template<class U>
+    [[maybe_unused]] bool
+    operator==(const polymorphic_allocator<U> &_other) const
+    {
+        return *_resource == *_other.resource();
+    }
+
+    template<class U>
+    [[maybe_unused]] bool
+    operator!=(const polymorphic_allocator<U> &_other) const
+    {
+        return *_resource != *_other.resource();
+    }
+
+private:
+    memory_resource *_resource;
+};
+
+}  // namespace dacal
+
+namespace detail {
+[[maybe_unused]] inline std::atomic<dacal::memory_resource *> &
+default_memory_resource()
+{
+    static std::atomic<dacal::memory_resource *> resource{
+        dacal::new_delete_resource()};
+    return resource;
+}
+
+}  // namespace detail
+
+#endif  // DACAL_MEMORY_RESOURCE_HPP
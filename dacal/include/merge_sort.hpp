@@ -0,0 +1,183 @@
+#ifndef DACAL_MERGE_SORT_HPP
+#define DACAL_MERGE_SORT_HPP
+
+#include "quick_sort.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace detail {
+// runs of this size are insertion sorted before merging starts
+constexpr std::size_t merge_sort_run = 32;
+
+// scratch space for sorts that move elements out of the range and back;
+// trivially copyable elements are used uninitialised, anything else is
+// constructed by a move from the range and moved straight back, which
+// leaves a valid object to assign to. If a move throws, the elements built
+// so far are destroyed again before the exception leaves the constructor
+template<class T>
+class sort_buffer
+{
+public:
+    template<class Iterator>
+    sort_buffer(Iterator array, std::size_t size) :
+        _data(std::allocator<T>().allocate(size)), _size(size)
+    {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            std::size_t constructed = 0;
+            try {
+                for (std::size_t i = 0; i < _size; ++i) {
+                    ::new (static_cast<void *>(_data + i))
+                        T(dacal::move(array[i]));
+                    constructed = i + 1;
+                    array[i] = dacal::move(_data[i]);
+                }
+            }
+            catch (...) {
+                while (constructed > 0)
+                    _data[--constructed].~T();
+                std::allocator<T>().deallocate(_data, _size);
+                throw;
+            }
+        }
+    }
+    sort_buffer(const sort_buffer &other) = delete;
+    ~sort_buffer()
+    {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            for (std::size_t i = 0; i < _size; ++i)
+                _data[i].~T();
+        }
+        std::allocator<T>().deallocate(_data, _size);
+    }
+
+    sort_buffer &operator=(const sort_buffer &other) = delete;
+
+    T *data() const
+    {
+        return _data;
+    }
+
+private:
+    T *_data;
+    std::size_t _size;
+};
+
+// merges two null terminated chains linked through _successor, on ties the
+// node from `first` goes first which keeps the merge stable
+template<class Node, class Compare>
+Node *merge_nodes(Node *first, Node *second, const Compare &compare)
+{
+    Node *head = nullptr;
+    Node **tail = &head;
+
+    while (first != nullptr && second != nullptr) {
+        if (compare(second->_data, first->_data)) {
+            *tail = second;
+            second = second->_successor;
+        }
+        else {
+            *tail = first;
+            first = first->_successor;
+        }
+        tail = &(*tail)->_successor;
+    }
+    *tail = first != nullptr ? first : second;
+    return head;
+}
+
+// bottom-up merge sort that only relinks _successor pointers, bins[i] holds
+// a sorted run of 2^i nodes so no allocation is needed
+template<class Node, class Compare>
+Node *merge_sort_nodes(Node *head, const Compare &compare)
+{
+    constexpr std::size_t bin_count = 64;
+    Node *bins[bin_count] = {};
+
+    while (head != nullptr) {
+        auto run = head;
+        head = head->_successor;
+        run->_successor = nullptr;
+
+        std::size_t i = 0;
+        for (; i < bin_count - 1 && bins[i] != nullptr; ++i) {
+            run = merge_nodes(bins[i], run, compare);
+            bins[i] = nullptr;
+        }
+        bins[i] = bins[i] ? merge_nodes(bins[i], run, compare) : run;
+    }
+
+    Node *result = nullptr;
+    for (std::size_t i = 0; i < bin_count; ++i) {
+        if (bins[i] != nullptr)
+            result = merge_nodes(bins[i], result, compare);
+    }
+    return result;
+}
+
+// merges source[low, middle) and source[middle, high) into the same
+// positions of destination, on ties the left run goes first
+template<class Source, class Destination, class Compare>
+void merge_runs(
+    Source source,
+    Destination destination,
+    std::size_t low,
+    std::size_t middle,
+    std::size_t high,
+    const Compare &compare)
+{
+    auto left = low, right = middle, out = low;
+    while (left < middle && right < high) {
+        if (compare(source[right], source[left]))
+            destination[out++] = dacal::move(source[right++]);
+        else
+            destination[out++] = dacal::move(source[left++]);
+    }
+    while (left < middle)
+        destination[out++] = dacal::move(source[left++]);
+    while (right < high)
+        destination[out++] = dacal::move(source[right++]);
+}
+
+// stable bottom-up merge sort of array[low, high), the merges alternate
+// between array and scratch[low, high)
+template<class Iterator, class Buffer, class Compare>
+void merge_sort(
+    Iterator array,
+    Buffer scratch,
+    std::size_t low,
+    std::size_t high,
+    const Compare &compare)
+{
+    for (auto first = low; first < high; first += merge_sort_run) {
+        auto last = high - first > merge_sort_run ? first + merge_sort_run
+                                                  : high;
+        insertion_sort(array, first, last, compare);
+    }
+
+    auto in_scratch = false;
+    for (auto width = merge_sort_run; width < high - low; width *= 2) {
+        for (auto first = low; first < high; first += 2 * width) {
+            auto middle = high - first > width ? first + width : high;
+            auto last = high - middle > width ? middle + width : high;
+            if (in_scratch)
+                merge_runs(scratch, array, first, middle, last, compare);
+            else
+                merge_runs(array, scratch, first, middle, last, compare);
+        }
+        in_scratch = !in_scratch;
+    }
+
+    if (in_scratch) {
+        for (auto i = low; i < high; ++i)
+            array[i] = dacal::move(scratch[i]);
+    }
+}
+
+}  // namespace detail
+
+#endif  // DACAL_MERGE_SORT_HPP
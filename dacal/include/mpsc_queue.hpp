@@ -0,0 +1,186 @@
+#ifndef DACAL_MPSC_QUEUE_HPP
+#define DACAL_MPSC_QUEUE_HPP
+
+#include "intrusive_list.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace dacal {
+struct [[maybe_unused]] mpsc_hook
+{
+    [[maybe_unused]] mpsc_hook() = default;
+
+    // an object copy is a new object, it is not linked anywhere
+    [[maybe_unused]] mpsc_hook(const mpsc_hook &) {}
+    [[maybe_unused]] mpsc_hook &operator=(const mpsc_hook &)
+    {
+        return *this;
+    }
+
+    std::atomic<mpsc_hook *> _successor{};
+};
+
+/*
+ *  Intrusive multi producer, single consumer FIFO queue (Vyukov). push()
+ *  is one atomic exchange on the head and never blocks; pop() and
+ *  drain_all() may only be called from one thread at a time. drain_all()
+ *  detaches every queued node with a single exchange.
+ **/
+template<class T, mpsc_hook T::*Hook>
+class [[maybe_unused]] mpsc_queue
+{
+public:
+    using value_type = T;
+    using reference = T &;
+
+    [[maybe_unused]] mpsc_queue();
+    [[maybe_unused]] mpsc_queue(const mpsc_queue &_other) = delete;
+    [[maybe_unused]] mpsc_queue &operator=(const mpsc_queue &_other) = delete;
+
+    [[maybe_unused]] void push(reference _data);
+    [[maybe_unused]] [[nodiscard]] T *pop();
+    template<class UnaryFunction>
+    [[maybe_unused]] std::size_t drain_all(const UnaryFunction &_func);
+    [[maybe_unused]] [[nodiscard]] bool empty() const;
+
+private:
+    [[maybe_unused]] static mpsc_hook *_hook(reference _data);
+    [[maybe_unused]] void _push(mpsc_hook *hook);
+    [[maybe_unused]] [[nodiscard]] bool _is_stub(const mpsc_hook *hook) const;
+
+    // producers only touch _head, the consumer owns _tail, keep them on
+    // separate cache lines
+    alignas(64) std::atomic<mpsc_hook *> _head;
+    alignas(64) mpsc_hook *_tail;
+    // pop() parks _stub behind the last node so that node can leave;
+    // drain_all() restarts the chain at _drain_stub, which is only ever
+    // linked as the tail, so it is free again once the tail moved past it
+    mpsc_hook _stub;
+    mpsc_hook _drain_stub;
+};
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] mpsc_queue<T, Hook>::mpsc_queue() :
+    _head(&_stub),
+    _tail(&_stub)
+{}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] mpsc_hook *mpsc_queue<T, Hook>::_hook(reference _data)
+{
+    return detail::intrusive_hook<T, mpsc_hook, Hook>(_data);
+}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] void mpsc_queue<T, Hook>::_push(mpsc_hook *hook)
+{
+    hook->_successor.store(nullptr, std::memory_order_relaxed);
+    auto predecessor = _head.exchange(hook, std::memory_order_acq_rel);
+
+    // until this store lands the consumer sees the chain end at predecessor
+    predecessor->_successor.store(hook, std::memory_order_release);
+}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] bool
+mpsc_queue<T, Hook>::_is_stub(const mpsc_hook *hook) const
+{
+    return hook == &_stub || hook == &_drain_stub;
+}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] void mpsc_queue<T, Hook>::push(reference _data)
+{
+    _push(_hook(_data));
+}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] T *mpsc_queue<T, Hook>::pop()
+{
+    auto tail = _tail;
+    auto successor = tail->_successor.load(std::memory_order_acquire);
+
+    if (_is_stub(tail)) {
+        if (successor == nullptr)
+            return nullptr;
+        _tail = tail = successor;
+        successor = successor->_successor.load(std::memory_order_acquire);
+    }
+
+    if (successor != nullptr) {
+        _tail = successor;
+        return detail::intrusive_owner<T, mpsc_hook, Hook>(tail);
+    }
+
+    // tail is not the last node, a producer is between its exchange and
+    // its link store
+    if (tail != _head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // tail is the only node left, park the stub behind it so it can leave
+    _push(&_stub);
+    successor = tail->_successor.load(std::memory_order_acquire);
+    if (successor != nullptr) {
+        _tail = successor;
+        return detail::intrusive_owner<T, mpsc_hook, Hook>(tail);
+    }
+    return nullptr;
+}
+
+template<class T, mpsc_hook T::*Hook>
+template<class UnaryFunction>
+[[maybe_unused]] std::size_t
+mpsc_queue<T, Hook>::drain_all(const UnaryFunction &_func)
+{
+    // a stub at the tail is passed first, which also frees _drain_stub
+    auto node = _tail;
+    if (_is_stub(node)) {
+        auto successor = node->_successor.load(std::memory_order_acquire);
+        if (successor == nullptr)
+            return 0;
+        node = _tail = successor;
+    }
+
+    // one exchange swings the producers onto a new chain starting at
+    // _drain_stub and hands the consumer everything up to the old head;
+    // nodes pushed from here on are left for the next call
+    _drain_stub._successor.store(nullptr, std::memory_order_relaxed);
+    auto last = _head.exchange(&_drain_stub, std::memory_order_acq_rel);
+    _tail = &_drain_stub;
+
+    std::size_t _drained = 0;
+    for (;;) {
+        // the link is read before _func gets the node, which may push it
+        // again; a producer between its exchange and its link store is
+        // waited for, that window is a single store long
+        mpsc_hook *successor = nullptr;
+        if (node != last) {
+            while (!(successor =
+                         node->_successor.load(std::memory_order_acquire)))
+                std::this_thread::yield();
+        }
+        if (!_is_stub(node)) {
+            ++_drained;
+            _func(*detail::intrusive_owner<T, mpsc_hook, Hook>(node));
+        }
+        if (node == last)
+            break;
+        node = successor;
+    }
+    return _drained;
+}
+
+template<class T, mpsc_hook T::*Hook>
+[[maybe_unused]] [[nodiscard]] bool mpsc_queue<T, Hook>::empty() const
+{
+    return _is_stub(_tail) &&
+        _tail->_successor.load(std::memory_order_acquire) == nullptr &&
+        _head.load(std::memory_order_acquire) == _tail;
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_MPSC_QUEUE_HPP
@@ -5,7 +5,8 @@ namespace dacal {
 template<class T1, class T2>
 struct [[maybe_unused]] pair
 {
-    [[maybe_unused]] pair(const T1 &first, const T2 &second) :
+    [[maybe_unused]] constexpr pair() = default;
+    [[maybe_unused]] constexpr pair(const T1 &first, const T2 &second) :
         _first(first),
         _second(second)
     {}
@@ -15,7 +16,7 @@ struct [[maybe_unused]] pair
 };
 
 template<class T1, class T2>
-[[maybe_unused]] dacal::pair<T1, T2>
+[[maybe_unused]] constexpr dacal::pair<T1, T2>
 make_pair(const T1 &first, const T2 &second)
 {
     return dacal::pair<T1, T2>(first, second);
@@ -0,0 +1,204 @@
+#ifndef DACAL_PARALLEL_SORT_HPP
+#define DACAL_PARALLEL_SORT_HPP
+
+#include "merge_sort.hpp"
+#include "quick_sort.hpp"
+#include "thread_pool.hpp"
+#include "tim_sort.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace detail {
+// every thread gets at least this many elements, smaller inputs are sorted
+// on the calling thread alone
+constexpr std::size_t parallel_sort_threshold = 1 << 15;
+
+// more buckets than threads even out the per bucket sorting work
+constexpr std::size_t sample_sort_buckets_per_thread = 4;
+
+// bucket ids are stored in a byte per element
+constexpr std::size_t sample_sort_max_buckets = 256;
+
+// samples drawn per bucket when picking splitters
+constexpr std::size_t sample_sort_oversampling = 32;
+
+template<class Iterator, class Compare>
+void serial_sort(
+    Iterator array, std::size_t size, const Compare &compare, bool stable)
+{
+    using value_type = std::remove_cvref_t<decltype(array[0])>;
+
+    if (!stable) {
+        quick_sort(array, size, compare);
+        return;
+    }
+
+    dacal::stable_sort_buffer<value_type> buffer;
+    tim_sort(array, size, buffer, compare);
+}
+
+// index of the range between splitters an element falls into: the number
+// of splitters not greater than it, so equal elements share a range
+template<class Iterator, class Compare>
+std::size_t sample_sort_bucket(
+    Iterator array,
+    const std::size_t *splitters,
+    std::size_t splitter_count,
+    const typename std::remove_cvref_t<decltype(array[0])> &value,
+    const Compare &compare)
+{
+    std::size_t bucket = 0;
+    while (splitter_count > 0) {
+        auto half = splitter_count / 2;
+        if (compare(value, array[splitters[bucket + half]])) {
+            splitter_count = half;
+        }
+        else {
+            bucket += half + 1;
+            splitter_count -= half + 1;
+        }
+    }
+    return bucket;
+}
+
+/*
+ *  Splitters picked from a sorted sample cut the input into buckets. Each
+ *  thread classifies a chunk, the chunks are scattered into a buffer
+ *  bucket by bucket, and the buckets are sorted independently and moved
+ *  back. The scatter keeps the input order inside a bucket, so with a
+ *  stable bucket sort the whole sort is stable.
+ *
+ *  A value picked as splitter more than once is frequent, the elements
+ *  equal to it get a bucket of their own that needs no sorting (as in
+ *  IPS4o). Input with few distinct keys thus does not end up in a single
+ *  bucket one thread sorts.
+ **/
+template<class Iterator, class Compare>
+void sample_sort(
+    Iterator array,
+    std::size_t size,
+    const Compare &compare,
+    bool stable,
+    dacal::thread_pool &pool)
+{
+    using value_type = std::remove_cvref_t<decltype(array[0])>;
+
+    auto threads = size / parallel_sort_threshold;
+    if (threads > pool.size())
+        threads = pool.size();
+    if (threads < 2) {
+        serial_sort(array, size, compare, stable);
+        return;
+    }
+
+    auto bucket_count = threads * sample_sort_buckets_per_thread;
+    if (bucket_count > sample_sort_max_buckets)
+        bucket_count = sample_sort_max_buckets;
+
+    // one sample from a random spot of every stride, so periodic input does
+    // not skew the splitters
+    auto sample_count = bucket_count * sample_sort_oversampling;
+    auto stride = size / sample_count;
+    std::unique_ptr<std::size_t[]> samples(new std::size_t[sample_count]);
+    for (std::size_t i = 0; i < sample_count; ++i)
+        samples[i] = i * stride + hash_mix(i) % stride;
+    quick_sort(
+        samples.get(),
+        sample_count,
+        [&array, &compare](std::size_t lhs, std::size_t rhs) {
+            return compare(array[lhs], array[rhs]);
+        });
+
+    // equal splitters collapse into one that is marked as repeated
+    std::unique_ptr<std::size_t[]> splitters(new std::size_t[bucket_count]);
+    std::unique_ptr<bool[]> repeated(new bool[bucket_count]());
+    std::size_t splitter_count = 0;
+    for (std::size_t i = 1; i < bucket_count; ++i) {
+        auto sample = samples[i * sample_sort_oversampling];
+        if (splitter_count > 0 &&
+            !compare(array[splitters[splitter_count - 1]], array[sample]))
+            repeated[splitter_count - 1] = true;
+        else
+            splitters[splitter_count++] = sample;
+    }
+
+    // buckets in order: the range below splitter j, then the equality
+    // bucket of j if it is repeated. A repeated splitter dropped a copy, so
+    // there are no more buckets than before
+    std::unique_ptr<std::size_t[]> range_bucket(
+        new std::size_t[splitter_count + 1]);
+    std::unique_ptr<std::size_t[]> equal_bucket(
+        new std::size_t[splitter_count]);
+    std::unique_ptr<bool[]> sorted(new bool[bucket_count]());
+    bucket_count = 0;
+    for (std::size_t j = 0; j <= splitter_count; ++j) {
+        range_bucket[j] = bucket_count++;
+        if (j < splitter_count && repeated[j]) {
+            equal_bucket[j] = bucket_count;
+            sorted[bucket_count++] = true;
+        }
+    }
+
+    auto chunk_low = [size, threads](std::size_t chunk) {
+        return chunk * size / threads;
+    };
+
+    std::unique_ptr<unsigned char[]> buckets(new unsigned char[size]);
+    std::unique_ptr<std::size_t[]> offsets(
+        new std::size_t[threads * bucket_count]());
+    pool.run(threads, [&](std::size_t chunk) {
+        auto count = offsets.get() + chunk * bucket_count;
+        for (auto i = chunk_low(chunk); i < chunk_low(chunk + 1); ++i) {
+            auto range = sample_sort_bucket(
+                array, splitters.get(), splitter_count, array[i], compare);
+            auto bucket = range > 0 && repeated[range - 1] &&
+                    !compare(array[splitters[range - 1]], array[i])
+                ? equal_bucket[range - 1]
+                : range_bucket[range];
+            buckets[i] = static_cast<unsigned char>(bucket);
+            ++count[bucket];
+        }
+    });
+
+    // counts become scatter positions: bucket by bucket, and inside a
+    // bucket chunk by chunk
+    std::unique_ptr<std::size_t[]> bounds(new std::size_t[bucket_count + 1]);
+    std::size_t position = 0;
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        bounds[bucket] = position;
+        for (std::size_t chunk = 0; chunk < threads; ++chunk) {
+            auto &offset = offsets[chunk * bucket_count + bucket];
+            auto count = offset;
+            offset = position;
+            position += count;
+        }
+    }
+    bounds[bucket_count] = size;
+
+    sort_buffer<value_type> buffer(array, size);
+    auto data = buffer.data();
+    pool.run(threads, [&](std::size_t chunk) {
+        auto offset = offsets.get() + chunk * bucket_count;
+        for (auto i = chunk_low(chunk); i < chunk_low(chunk + 1); ++i)
+            data[offset[buckets[i]]++] = dacal::move(array[i]);
+    });
+
+    pool.run(bucket_count, [&](std::size_t bucket) {
+        auto low = bounds[bucket], high = bounds[bucket + 1];
+        // an equality bucket is sorted already
+        if (!sorted[bucket] && stable)
+            merge_sort(data, array, low, high, compare);
+        else if (!sorted[bucket])
+            quick_sort(data + low, high - low, compare);
+
+        for (auto i = low; i < high; ++i)
+            array[i] = dacal::move(data[i]);
+    });
+}
+
+}  // namespace detail
+
+#endif  // DACAL_PARALLEL_SORT_HPP
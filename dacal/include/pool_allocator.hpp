@@ -0,0 +1,271 @@
+#ifndef DACAL_POOL_ALLOCATOR_HPP
+#define DACAL_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace detail {
+// 16 byte steps up to 128, then powers of two up to 2048; anything larger
+// goes straight to operator new
+constexpr std::size_t pool_class_count = 12;
+constexpr std::size_t pool_max_block = 2048;
+constexpr std::size_t pool_span_bytes = 64 * 1024;
+
+constexpr std::size_t pool_size_class(std::size_t bytes)
+{
+    if (bytes <= 128)
+        return bytes == 0 ? 0 : (bytes - 1) / 16;
+
+    std::size_t index = 8;
+    for (std::size_t size = 256; size < bytes; size *= 2)
+        ++index;
+    return index;
+}
+
+constexpr std::size_t pool_block_size(std::size_t index)
+{
+    return index < 8 ? (index + 1) * 16 : std::size_t{256} << (index - 8);
+}
+
+// number of blocks moved between a thread cache and the central pool at once
+constexpr std::size_t pool_batch_size(std::size_t index)
+{
+    auto batch = 8192 / pool_block_size(index);
+    return batch < 4 ? 4 : (batch > 64 ? 64 : batch);
+}
+
+struct pool_block
+{
+    pool_block *_successor;
+};
+
+/*
+ *  Process wide free lists, one per size class. Thread caches only come
+ *  here a batch at a time, so each lock is amortized over many blocks.
+ *  Spans are never handed back to the system.
+ **/
+class pool_central
+{
+public:
+    [[maybe_unused]] static pool_central &instance()
+    {
+        // leaked on purpose, thread caches may flush into it during exit
+        static auto central = new pool_central;
+        return *central;
+    }
+
+    [[maybe_unused]] void
+    release(std::size_t index, pool_block *first, pool_block *last)
+    {
+        auto &bin = _bins[index];
+        std::lock_guard<std::mutex> lock(bin._mutex);
+        last->_successor = bin._free;
+        bin._free = first;
+    }
+
+    [[maybe_unused]] pool_block *acquire(std::size_t index, std::size_t count)
+    {
+        auto &bin = _bins[index];
+        std::lock_guard<std::mutex> lock(bin._mutex);
+
+        if (bin._free == nullptr)
+            _carve(index, bin);
+
+        auto first = bin._free, last = first;
+        for (std::size_t i = 1; i < count && last->_successor != nullptr; ++i)
+            last = last->_successor;
+        bin._free = last->_successor;
+        last->_successor = nullptr;
+        return first;
+    }
+
+private:
+    struct alignas(64) bin_type
+    {
+        std::mutex _mutex;
+        pool_block *_free{};
+    };
+
+    [[maybe_unused]] static void _carve(std::size_t index, bin_type &bin)
+    {
+        auto size = pool_block_size(index);
+        auto span = static_cast<char *>(::operator new(pool_span_bytes));
+
+        pool_block *head = nullptr;
+        for (auto offset = pool_span_bytes / size * size; offset != 0;) {
+            offset -= size;
+            auto block = reinterpret_cast<pool_block *>(span + offset);
+            block->_successor = head;
+            head = block;
+        }
+        bin._free = head;
+    }
+
+    bin_type _bins[pool_class_count];
+};
+
+class pool_thread_cache
+{
+public:
+    [[maybe_unused]] pool_thread_cache() = default;
+    [[maybe_unused]] pool_thread_cache(const pool_thread_cache &) = delete;
+    [[maybe_unused]] ~pool_thread_cache()
+    {
+        _destroyed = true;
+        for (std::size_t i = 0; i < pool_class_count; ++i) {
+            if (_bins[i]._count != 0)
+                _flush(i, _bins[i]._count);
+        }
+    }
+
+    // nullptr once the cache of this thread is destroyed: thread_locals
+    // destroyed after it may still free pool memory. The flag is checked
+    // before the definition of the cache is reached again, which would be
+    // undefined
+    [[maybe_unused]] static pool_thread_cache *local()
+    {
+        if (_destroyed)
+            return nullptr;
+        thread_local pool_thread_cache cache;
+        return &cache;
+    }
+
+    [[maybe_unused]] void *allocate(std::size_t index)
+    {
+        auto &bin = _bins[index];
+        if (bin._free == nullptr) {
+            bin._free = pool_central::instance().acquire(
+                index, pool_batch_size(index));
+            for (auto i = bin._free; i != nullptr; i = i->_successor)
+                ++bin._count;
+        }
+
+        auto block = bin._free;
+        bin._free = block->_successor;
+        --bin._count;
+        return block;
+    }
+
+    [[maybe_unused]] void deallocate(std::size_t index, void *ptr)
+    {
+        auto &bin = _bins[index];
+        auto block = static_cast<pool_block *>(ptr);
+        block->_successor = bin._free;
+        bin._free = block;
+
+        // keep one batch around so alternating alloc/free does not bounce
+        // blocks through the central lock
+        if (++bin._count >= 2 * pool_batch_size(index))
+            _flush(index, pool_batch_size(index));
+    }
+
+private:
+    struct bin_type
+    {
+        pool_block *_free{};
+        std::size_t _count{};
+    };
+
+    [[maybe_unused]] void _flush(std::size_t index, std::size_t count)
+    {
+        auto &bin = _bins[index];
+        auto first = bin._free, last = first;
+        for (std::size_t i = 1; i < count; ++i)
+            last = last->_successor;
+
+        bin._free = last->_successor;
+        bin._count -= count;
+        pool_central::instance().release(index, first, last);
+    }
+
+    bin_type _bins[pool_class_count];
+
+    // trivially destructible, so still readable after the cache is gone
+    static inline thread_local bool _destroyed = false;
+};
+
+// without a cache single blocks are traded with the central pool
+inline void *pool_allocate(std::size_t index)
+{
+    auto cache = pool_thread_cache::local();
+    if (cache == nullptr)
+        return pool_central::instance().acquire(index, 1);
+    return cache->allocate(index);
+}
+
+inline void pool_deallocate(std::size_t index, void *ptr)
+{
+    auto cache = pool_thread_cache::local();
+    if (cache == nullptr) {
+        auto block = static_cast<pool_block *>(ptr);
+        pool_central::instance().release(index, block, block);
+        return;
+    }
+    cache->deallocate(index, ptr);
+}
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Stateless size class allocator. Small blocks come from a per thread
+ *  cache that trades with a central pool in batches; memory freed on
+ *  another thread simply joins that thread's cache. Once a thread's cache
+ *  is destroyed at thread exit, it uses the central pool directly.
+ **/
+template<class T>
+class [[maybe_unused]] pool_allocator
+{
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    [[maybe_unused]] pool_allocator() noexcept = default;
+
+    template<class U>
+    [[maybe_unused]] pool_allocator(const pool_allocator<U> &) noexcept
+    {}
+
+    [[maybe_unused]] [[nodiscard]] T *allocate(std::size_t _n)
+    {
+        auto _bytes = _n * sizeof(T);
+        if (_bytes > detail::pool_max_block || alignof(T) > 16)
+            return static_cast<T *>(
+                ::operator new(_bytes, std::align_val_t(alignof(T))));
+
+        return static_cast<T *>(
+            detail::pool_allocate(detail::pool_size_class(_bytes)));
+    }
+
+    [[maybe_unused]] void deallocate(T *_ptr, std::size_t _n) noexcept
+    {
+        if (_ptr == nullptr)
+            return;
+
+        auto _bytes = _n * sizeof(T);
+        if (_bytes > detail::pool_max_block || alignof(T) > 16) {
+            ::operator delete(_ptr, std::align_val_t(alignof(T)));
+            return;
+        }
+
+        detail::pool_deallocate(detail::pool_size_class(_bytes), _ptr);
+    }
+
+    template<class U>
+    [[maybe_unused]] bool operator==(const pool_allocator<U> &) const
+    {
+        return true;
+    }
+
+    template<class U>
+    [[maybe_unused]] bool operator!=(const pool_allocator<U> &) const
+    {
+        return false;
+    }
+};
+
+}  // namespace dacal
+
+#endif  // DACAL_POOL_ALLOCATOR_HPP
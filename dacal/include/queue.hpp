@@ -10,6 +10,10 @@ class [[maybe_unused]] queue
 public:
     [[maybe_unused]] queue() = default;
 
+    template<class Alloc>
+    [[maybe_unused]] explicit queue(const Alloc &_alloc) : _container(_alloc)
+    {}
+
     [[maybe_unused]] void push(const T &data)
     {
         _container.push_back(data);
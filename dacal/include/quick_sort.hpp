@@ -4,35 +4,512 @@
 #include "iterator.hpp"
 #include "utils.hpp"
 
+#include <cstddef>
+#include <type_traits>
+
 namespace detail {
+// below this size insertion sort beats partitioning
+constexpr std::size_t insertion_sort_threshold = 24;
+
+// above this size the pivot is the median of three medians (ninther)
+constexpr std::size_t ninther_threshold = 128;
+
+// an insertion sort pass over a partition that looks sorted gives up after
+// moving this many elements
+constexpr std::size_t partial_insertion_sort_limit = 8;
+
+// elements classified per block by the branchless partition
+constexpr std::size_t partition_block_size = 64;
+
+// for these the comparison is a single instruction whose result can be used
+// as an integer, so partitioning without branches pays off
+template<class T, class Compare>
+constexpr bool branchless_sortable = std::is_arithmetic_v<T> &&
+    (std::is_same_v<Compare, dacal::less<T>> ||
+     std::is_same_v<Compare, dacal::greater<T>>);
+
+template<class Iterator, class Compare>
+void insertion_sort(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    for (auto i = low + 1; i < high; ++i) {
+        if (!compare(array[i], array[i - 1]))
+            continue;
+
+        auto value = dacal::move(array[i]);
+        auto j = i;
+        do {
+            array[j] = dacal::move(array[j - 1]);
+            --j;
+        } while (j > low && compare(value, array[j - 1]));
+        array[j] = dacal::move(value);
+    }
+}
+
+// insertion sort that gives up once it has moved too many elements; returns
+// whether the range ended up sorted
+template<class Iterator, class Compare>
+bool partial_insertion_sort(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    std::size_t moved = 0;
+    for (auto i = low + 1; i < high; ++i) {
+        if (!compare(array[i], array[i - 1]))
+            continue;
+
+        auto value = dacal::move(array[i]);
+        auto j = i;
+        do {
+            array[j] = dacal::move(array[j - 1]);
+            --j;
+        } while (j > low && compare(value, array[j - 1]));
+        array[j] = dacal::move(value);
+
+        moved += i - j;
+        if (moved > partial_insertion_sort_limit)
+            return false;
+    }
+    return true;
+}
+
+// sorted input is left alone and reverse sorted input is reversed, both in
+// one linear pass; returns whether the range is now sorted
 template<class Iterator, class Compare>
-int partition(Iterator array, int low, int high, const Compare &compare)
+bool sort_presorted(Iterator array, std::size_t size, const Compare &compare)
 {
-    auto middle = (low + high) / 2;
-    dacal::swap(array[middle], array[high]);
-    auto pivot = array[high];
+    if (size < 2)
+        return true;
+
+    std::size_t i = 1;
+    if (!compare(array[1], array[0])) {
+        while (i < size && !compare(array[i], array[i - 1]))
+            ++i;
+        return i == size;
+    }
+
+    while (i < size && !compare(array[i - 1], array[i]))
+        ++i;
+    if (i != size)
+        return false;
+
+    for (std::size_t low = 0, high = size - 1; low < high; ++low, --high)
+        dacal::swap(array[low], array[high]);
+    return true;
+}
+
+// orders array[a] <= array[b] <= array[c]
+template<class Iterator, class Compare>
+void sort3(
+    Iterator array,
+    std::size_t a,
+    std::size_t b,
+    std::size_t c,
+    const Compare &compare)
+{
+    if (compare(array[b], array[a]))
+        dacal::swap(array[a], array[b]);
+    if (compare(array[c], array[b])) {
+        dacal::swap(array[b], array[c]);
+        if (compare(array[b], array[a]))
+            dacal::swap(array[a], array[b]);
+    }
+}
+
+template<class Iterator, class Compare>
+void sift_down(
+    Iterator array,
+    std::size_t low,
+    std::size_t root,
+    std::size_t size,
+    const Compare &compare)
+{
+    auto value = dacal::move(array[low + root]);
+    for (auto child = 2 * root + 1; child < size; child = 2 * root + 1) {
+        if (child + 1 < size &&
+            compare(array[low + child], array[low + child + 1]))
+            ++child;
+        if (!compare(value, array[low + child]))
+            break;
+        array[low + root] = dacal::move(array[low + child]);
+        root = child;
+    }
+    array[low + root] = dacal::move(value);
+}
+
+// heaps are max heaps under compare, rooted at array[low]
+template<class Iterator, class Compare>
+void make_heap(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    auto size = high - low;
+    for (auto i = size / 2; i > 0; --i)
+        sift_down(array, low, i - 1, size, compare);
+}
+
+template<class Iterator, class Compare>
+void sort_heap(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    for (auto end = high - low; end > 1; --end) {
+        dacal::swap(array[low], array[low + end - 1]);
+        sift_down(array, low, 0, end - 1, compare);
+    }
+}
+
+template<class Iterator, class Compare>
+void heap_sort(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    make_heap(array, low, high, compare);
+    sort_heap(array, low, high, compare);
+}
+
+// moves the chosen pivot to array[low]; the range keeps at least one element
+// not less and one not greater than it, which the partition scans below rely
+// on as sentinels
+template<class Iterator, class Compare>
+void choose_pivot(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    auto size = high - low;
+    auto mid = low + size / 2;
+    if (size > ninther_threshold) {
+        sort3(array, low, mid, high - 1, compare);
+        sort3(array, low + 1, mid - 1, high - 2, compare);
+        sort3(array, low + 2, mid + 1, high - 3, compare);
+        sort3(array, mid - 1, mid, mid + 1, compare);
+        dacal::swap(array[low], array[mid]);
+    }
+    else {
+        sort3(array, mid, low, high - 1, compare);
+    }
+}
+
+// elements less than the pivot go left, the rest right; returns the pivot's
+// final position
+template<class Iterator, class Compare>
+std::size_t partition_right(
+    Iterator array,
+    std::size_t low,
+    std::size_t high,
+    const Compare &compare,
+    bool &already_partitioned)
+{
+    auto pivot = dacal::move(array[low]);
+    auto first = low, last = high;
+
+    while (compare(array[++first], pivot))
+        ;
+    if (first - 1 == low) {
+        while (first < last && !compare(array[--last], pivot))
+            ;
+    }
+    else {
+        while (!compare(array[--last], pivot))
+            ;
+    }
 
-    auto greater_th_pivot = 0, current = 0;
-    for (; current < high; current++) {
-        if (compare.operator()(array[current], pivot)) {
-            dacal::swap(array[greater_th_pivot], array[current]);
-            greater_th_pivot++;
+    already_partitioned = first >= last;
+    while (first < last) {
+        dacal::swap(array[first], array[last]);
+        while (compare(array[++first], pivot))
+            ;
+        while (!compare(array[--last], pivot))
+            ;
+    }
+
+    auto pivot_pos = first - 1;
+    array[low] = dacal::move(array[pivot_pos]);
+    array[pivot_pos] = dacal::move(pivot);
+    return pivot_pos;
+}
+
+// exchanges the misplaced elements recorded by partition_right_branchless;
+// with unequal counts a cyclic rotation does it in one move per element
+template<class Iterator>
+void swap_offsets(
+    Iterator array,
+    std::size_t left_base,
+    std::size_t right_base,
+    const unsigned char *left_offsets,
+    const unsigned char *right_offsets,
+    std::size_t count,
+    bool use_swaps)
+{
+    if (use_swaps) {
+        for (std::size_t i = 0; i < count; ++i) {
+            dacal::swap(
+                array[left_base + left_offsets[i]],
+                array[right_base - right_offsets[i]]);
         }
+        return;
     }
+    if (count == 0)
+        return;
 
-    dacal::swap(array[greater_th_pivot], array[high]);
-    return greater_th_pivot;
+    auto left = left_base + left_offsets[0];
+    auto right = right_base - right_offsets[0];
+    auto value = dacal::move(array[left]);
+    array[left] = dacal::move(array[right]);
+    for (std::size_t i = 1; i < count; ++i) {
+        left = left_base + left_offsets[i];
+        array[right] = dacal::move(array[left]);
+        right = right_base - right_offsets[i];
+        array[left] = dacal::move(array[right]);
+    }
+    array[right] = dacal::move(value);
 }
 
+// BlockQuicksort: the same partition as partition_right, but both ends are
+// first classified a block at a time into offset buffers, where the outcome
+// of a comparison only moves a counter, and the swaps happen afterwards
 template<class Iterator, class Compare>
-void qsort_helper(Iterator array, int low, int high, const Compare &compare)
+std::size_t partition_right_branchless(
+    Iterator array,
+    std::size_t low,
+    std::size_t high,
+    const Compare &compare,
+    bool &already_partitioned)
+{
+    auto pivot = dacal::move(array[low]);
+    auto first = low, last = high;
+
+    while (compare(array[++first], pivot))
+        ;
+    if (first - 1 == low) {
+        while (first < last && !compare(array[--last], pivot))
+            ;
+    }
+    else {
+        while (!compare(array[--last], pivot))
+            ;
+    }
+
+    already_partitioned = first >= last;
+    if (!already_partitioned) {
+        dacal::swap(array[first], array[last]);
+        ++first;
+
+        alignas(64) unsigned char left_offsets[partition_block_size];
+        alignas(64) unsigned char right_offsets[partition_block_size];
+        auto left_base = first, right_base = last;
+        std::size_t left_count = 0, right_count = 0;
+        std::size_t left_start = 0, right_start = 0;
+
+        while (first < last) {
+            // fill whichever buffer is empty, splitting what is left when
+            // both are
+            auto unknown = last - first;
+            auto left_split = left_count == 0
+                ? (right_count == 0 ? unknown / 2 : unknown)
+                : 0;
+            auto right_split = right_count == 0 ? unknown - left_split : 0;
+
+            if (left_split > partition_block_size)
+                left_split = partition_block_size;
+            for (std::size_t i = 0; i < left_split; ++i) {
+                left_offsets[left_count] = static_cast<unsigned char>(i);
+                left_count += !compare(array[first], pivot);
+                ++first;
+            }
+
+            if (right_split > partition_block_size)
+                right_split = partition_block_size;
+            for (std::size_t i = 0; i < right_split;) {
+                right_offsets[right_count] = static_cast<unsigned char>(++i);
+                right_count += compare(array[--last], pivot);
+            }
+
+            auto count = left_count < right_count ? left_count : right_count;
+            swap_offsets(
+                array,
+                left_base,
+                right_base,
+                left_offsets + left_start,
+                right_offsets + right_start,
+                count,
+                left_count == right_count);
+            left_count -= count;
+            right_count -= count;
+            left_start += count;
+            right_start += count;
+
+            if (left_count == 0) {
+                left_start = 0;
+                left_base = first;
+            }
+            if (right_count == 0) {
+                right_start = 0;
+                right_base = last;
+            }
+        }
+
+        // one buffer may still hold misplaced elements, move them to the
+        // boundary
+        if (left_count != 0) {
+            while (left_count-- != 0) {
+                dacal::swap(
+                    array[left_base + left_offsets[left_start + left_count]],
+                    array[--last]);
+            }
+            first = last;
+        }
+        if (right_count != 0) {
+            while (right_count-- != 0) {
+                dacal::swap(
+                    array
+                        [right_base - right_offsets[right_start + right_count]],
+                    array[first]);
+                ++first;
+            }
+        }
+    }
+
+    auto pivot_pos = first - 1;
+    array[low] = dacal::move(array[pivot_pos]);
+    array[pivot_pos] = dacal::move(pivot);
+    return pivot_pos;
+}
+
+// the three way step: called when the pivot equals the element just left of
+// the range, so nothing in the range is smaller; gathers every element equal
+// to the pivot on the left and returns the end of that run
+template<class Iterator, class Compare>
+std::size_t partition_equal(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    auto pivot = dacal::move(array[low]);
+    auto first = low, last = high;
+
+    while (compare(pivot, array[--last]))
+        ;
+    if (last + 1 == high) {
+        while (first < last && !compare(pivot, array[++first]))
+            ;
+    }
+    else {
+        while (!compare(pivot, array[++first]))
+            ;
+    }
+
+    while (first < last) {
+        dacal::swap(array[first], array[last]);
+        while (compare(pivot, array[--last]))
+            ;
+        while (!compare(pivot, array[++first]))
+            ;
+    }
+
+    array[low] = dacal::move(array[last]);
+    array[last] = dacal::move(pivot);
+    return last + 1;
+}
+
+// swaps a few elements at fixed spots of a range, after a lopsided split
+// this breaks the pattern that caused it
+template<class Iterator>
+void break_patterns(Iterator array, std::size_t low, std::size_t high)
 {
-    if (low < high) {
-        auto pivot_offset = partition(array, low, high, compare);
+    auto size = high - low;
+    auto quarter = size / 4;
+    dacal::swap(array[low], array[low + quarter]);
+    dacal::swap(array[high - 1], array[high - quarter]);
+    if (size > ninther_threshold) {
+        dacal::swap(array[low + 1], array[low + quarter + 1]);
+        dacal::swap(array[low + 2], array[low + quarter + 2]);
+        dacal::swap(array[high - 2], array[high - quarter - 1]);
+        dacal::swap(array[high - 3], array[high - quarter - 2]);
+    }
+}
+
+template<bool Branchless, class Iterator, class Compare>
+void introsort(
+    Iterator array,
+    std::size_t low,
+    std::size_t high,
+    std::size_t bad_allowed,
+    const Compare &compare,
+    bool leftmost)
+{
+    // recurse into the smaller side and loop on the larger, so the stack
+    // never holds more than log2(n) frames
+    while (high - low > insertion_sort_threshold) {
+        auto size = high - low;
+        choose_pivot(array, low, high, compare);
+        if (!leftmost && !compare(array[low - 1], array[low])) {
+            low = partition_equal(array, low, high, compare);
+            continue;
+        }
+
+        bool already_partitioned;
+        std::size_t pivot_pos;
+        if constexpr (Branchless) {
+            pivot_pos = partition_right_branchless(
+                array, low, high, compare, already_partitioned);
+        }
+        else {
+            pivot_pos = partition_right(
+                array, low, high, compare, already_partitioned);
+        }
+
+        auto left_size = pivot_pos - low;
+        auto right_size = high - (pivot_pos + 1);
+        if (left_size < size / 8 || right_size < size / 8) {
+            // too many lopsided splits mean an adversarial input, heapsort
+            // keeps the worst case at n log n
+            if (bad_allowed == 0) {
+                heap_sort(array, low, high, compare);
+                return;
+            }
+            --bad_allowed;
 
-        qsort_helper(array, low, pivot_offset - 1, compare);
-        qsort_helper(array, pivot_offset + 1, high, compare);
+            if (left_size > insertion_sort_threshold)
+                break_patterns(array, low, pivot_pos);
+            if (right_size > insertion_sort_threshold)
+                break_patterns(array, pivot_pos + 1, high);
+        }
+        else if (
+            already_partitioned &&
+            partial_insertion_sort(array, low, pivot_pos, compare) &&
+            partial_insertion_sort(array, pivot_pos + 1, high, compare)) {
+            // nothing moved during partitioning and both sides were nearly
+            // sorted, this is how mostly sorted input finishes in linear time
+            return;
+        }
+
+        if (left_size < right_size) {
+            introsort<Branchless>(
+                array, low, pivot_pos, bad_allowed, compare, leftmost);
+            low = pivot_pos + 1;
+            leftmost = false;
+        }
+        else {
+            introsort<Branchless>(
+                array, pivot_pos + 1, high, bad_allowed, compare, false);
+            high = pivot_pos;
+        }
     }
+    insertion_sort(array, low, high, compare);
+}
+
+constexpr std::size_t introsort_depth(std::size_t size)
+{
+    std::size_t depth = 0;
+    for (; size > 1; size >>= 1)
+        ++depth;
+    return depth;
+}
+
+template<class Iterator, class Compare>
+void quick_sort(Iterator array, std::size_t size, const Compare &compare)
+{
+    using value_type = std::remove_cvref_t<decltype(array[0])>;
+
+    if (sort_presorted(array, size, compare))
+        return;
+
+    introsort<branchless_sortable<value_type, Compare>>(
+        array, 0, size, introsort_depth(size), compare, true);
 }
 
 }  // namespace detail
@@ -0,0 +1,209 @@
+#ifndef DACAL_RADIX_SORT_HPP
+#define DACAL_RADIX_SORT_HPP
+
+#include "merge_sort.hpp"
+#include "quick_sort.hpp"
+#include "utils.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace detail {
+// below this size a bucket is finished with insertion sort
+constexpr std::size_t radix_insertion_threshold = 64;
+
+// keys up to this many bytes are sorted LSD, wider ones are split MSD until
+// the rest of the key fits
+constexpr std::size_t radix_lsd_bytes = 4;
+
+constexpr std::size_t radix_bucket_count = 256;
+
+// integers but bool, and the IEEE binary32 / binary64 floating point types;
+// long double has no portable bit layout to map onto an integer
+template<class T>
+concept radix_key_type =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+    (std::is_floating_point_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+
+struct radix_identity
+{
+    template<class T>
+    const T &operator()(const T &value) const
+    {
+        return value;
+    }
+};
+
+// maps a key onto an unsigned integer with the same order: signed keys get
+// their sign bit flipped, IEEE floats additionally have the magnitude bits
+// of negatives inverted
+template<radix_key_type Key>
+constexpr auto radix_unsigned(Key key)
+{
+    if constexpr (std::is_floating_point_v<Key>) {
+        using bits_type =
+            std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t>;
+
+        constexpr auto sign = bits_type(1) << (sizeof(Key) * 8 - 1);
+        auto bits = std::bit_cast<bits_type>(key);
+        return (bits & sign) != 0 ? bits_type(~bits) : bits_type(bits | sign);
+    }
+    else if constexpr (std::is_signed_v<Key>) {
+        using bits_type = std::make_unsigned_t<Key>;
+
+        constexpr auto sign = bits_type(1) << (sizeof(Key) * 8 - 1);
+        return bits_type(bits_type(key) ^ sign);
+    }
+    else {
+        return key;
+    }
+}
+
+template<class Bits>
+constexpr std::size_t radix_digit(Bits bits, std::size_t byte)
+{
+    return static_cast<std::size_t>((bits >> (byte * 8)) & 0xff);
+}
+
+// stable counting pass over one digit, source and destination share indices
+template<class Source, class Destination, class Key>
+void radix_scatter(
+    Source source,
+    Destination destination,
+    std::size_t low,
+    std::size_t high,
+    std::size_t *offsets,
+    const Key &key,
+    std::size_t byte)
+{
+    for (auto i = low; i < high; ++i) {
+        auto digit = radix_digit(radix_unsigned(key(source[i])), byte);
+        destination[offsets[digit]++] = dacal::move(source[i]);
+    }
+}
+
+// LSD over the low `bytes` bytes of the key; one read builds every histogram
+// and a digit every element shares costs no pass at all
+template<class Iterator, class T, class Key>
+void radix_lsd(
+    Iterator array,
+    T *buffer,
+    std::size_t low,
+    std::size_t high,
+    const Key &key,
+    std::size_t bytes)
+{
+    std::size_t counts[sizeof(uint64_t)][radix_bucket_count] = {};
+    for (auto i = low; i < high; ++i) {
+        auto bits = radix_unsigned(key(array[i]));
+        for (std::size_t byte = 0; byte < bytes; ++byte)
+            ++counts[byte][radix_digit(bits, byte)];
+    }
+
+    auto first_bits = radix_unsigned(key(array[low]));
+    auto in_buffer = false;
+    for (std::size_t byte = 0; byte < bytes; ++byte) {
+        auto count = counts[byte];
+        if (count[radix_digit(first_bits, byte)] == high - low)
+            continue;
+
+        std::size_t offsets[radix_bucket_count];
+        for (std::size_t digit = 0, sum = low; digit < radix_bucket_count;
+             ++digit) {
+            offsets[digit] = sum;
+            sum += count[digit];
+        }
+
+        if (in_buffer)
+            radix_scatter(buffer, array, low, high, offsets, key, byte);
+        else
+            radix_scatter(array, buffer, low, high, offsets, key, byte);
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        for (auto i = low; i < high; ++i)
+            array[i] = dacal::move(buffer[i]);
+    }
+}
+
+// MSD on the top byte, then every bucket is sorted on the bytes below it;
+// used for keys too wide for LSD to be worth one pass per byte
+template<class Iterator, class T, class Key>
+void radix_msd(
+    Iterator array,
+    T *buffer,
+    std::size_t low,
+    std::size_t high,
+    const Key &key,
+    std::size_t byte)
+{
+    auto compare = [&key](const auto &lhs, const auto &rhs) {
+        return radix_unsigned(key(lhs)) < radix_unsigned(key(rhs));
+    };
+
+    for (;; --byte) {
+        if (high - low <= radix_insertion_threshold) {
+            insertion_sort(array, low, high, compare);
+            return;
+        }
+        if (byte < radix_lsd_bytes) {
+            radix_lsd(array, buffer, low, high, key, byte + 1);
+            return;
+        }
+
+        std::size_t count[radix_bucket_count] = {};
+        for (auto i = low; i < high; ++i)
+            ++count[radix_digit(radix_unsigned(key(array[i])), byte)];
+        if (count[radix_digit(radix_unsigned(key(array[low])), byte)] ==
+            high - low)
+            continue;
+
+        std::size_t offsets[radix_bucket_count];
+        for (std::size_t digit = 0, sum = low; digit < radix_bucket_count;
+             ++digit) {
+            offsets[digit] = sum;
+            sum += count[digit];
+        }
+
+        radix_scatter(array, buffer, low, high, offsets, key, byte);
+        for (auto i = low; i < high; ++i)
+            array[i] = dacal::move(buffer[i]);
+
+        // offsets now hold the end of every bucket
+        for (std::size_t digit = 0, first = low; digit < radix_bucket_count;
+             ++digit) {
+            if (offsets[digit] - first > 1)
+                radix_msd(array, buffer, first, offsets[digit], key, byte - 1);
+            first = offsets[digit];
+        }
+        return;
+    }
+}
+
+template<class Iterator, class Key>
+void radix_sort(Iterator array, std::size_t size, const Key &key)
+{
+    using value_type = typename Iterator::value_type;
+    using key_type = decltype(radix_unsigned(key(array[0])));
+
+    if (size <= radix_insertion_threshold) {
+        insertion_sort(
+            array, 0, size, [&key](const auto &lhs, const auto &rhs) {
+                return radix_unsigned(key(lhs)) < radix_unsigned(key(rhs));
+            });
+        return;
+    }
+
+    sort_buffer<value_type> buffer(array, size);
+    if constexpr (sizeof(key_type) <= radix_lsd_bytes)
+        radix_lsd(array, buffer.data(), 0, size, key, sizeof(key_type));
+    else
+        radix_msd(array, buffer.data(), 0, size, key, sizeof(key_type) - 1);
+}
+
+}  // namespace detail
+
+#endif  // DACAL_RADIX_SORT_HPP
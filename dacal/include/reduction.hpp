@@ -0,0 +1,391 @@
+#ifndef DACAL_REDUCTION_HPP
+#define DACAL_REDUCTION_HPP
+
+#include "simd.hpp"
+#include "utils.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace detail {
+// independent accumulators of a reduction, four 64 byte registers: enough
+// to cover the latency of a vector add or multiply
+template<class T>
+constexpr std::size_t reduce_lanes = 256 / sizeof(T);
+
+// elements pairwise summation adds up in lanes before it starts pairing
+template<class T>
+constexpr std::size_t pairwise_sum_block = 16 * reduce_lanes<T>;
+
+// operations the kernels may regroup and reorder. Integer addition and
+// multiplication are taken modulo 2^n (see overflowing_reduction), min and
+// max only pick, so the result stays the same; floating point addition
+// rounds differently once regrouped and keeps its serial order unless
+// pairwise or kahan summation is asked for
+template<class T, class Operation>
+concept associative_reduction = simd_element<T> && std::is_integral_v<T> &&
+    (std::is_same_v<Operation, dacal::plus<T>> ||
+     std::is_same_v<Operation, dacal::multiplies<T>> ||
+     std::is_same_v<Operation, dacal::minimum<T>> ||
+     std::is_same_v<Operation, dacal::maximum<T>>);
+
+// a signed int or wider overflows, and regrouped lanes can overflow where
+// the serial order does not. Such sums and products are taken in the
+// unsigned type and converted back, which gives the serial result whenever
+// that is defined. Narrower types are promoted to int and cannot overflow
+template<class T, class Operation>
+concept overflowing_reduction = std::is_integral_v<T> &&
+    std::is_signed_v<T> && sizeof(T) >= sizeof(int) &&
+    (std::is_same_v<Operation, dacal::plus<T>> ||
+     std::is_same_v<Operation, dacal::multiplies<T>>);
+
+template<class Iterator, class T, class Operation>
+concept reduction_range = dacal::ContiguousIterator<Iterator> &&
+    std::is_same_v<typename Iterator::value_type, T> &&
+    associative_reduction<T, Operation>;
+
+// combines the lanes as a tree, which is shorter than a chain and, for
+// sums, rounds less
+template<class T, class Operation>
+[[gnu::always_inline]] inline T
+fold_lanes(T *partial, const Operation &operation)
+{
+    for (auto width = reduce_lanes<T> / 2; width > 0; width /= 2) {
+        for (std::size_t i = 0; i < width; ++i)
+            partial[i] = operation(partial[i], partial[i + width]);
+    }
+    return partial[0];
+}
+
+template<class T, class Operation>
+[[gnu::always_inline]] inline T block_reduce(
+    const T *first, const T *last, T init, const Operation &operation)
+{
+    constexpr auto lanes = reduce_lanes<T>;
+    if (static_cast<std::size_t>(last - first) >= lanes) {
+        T partial[lanes];
+        for (std::size_t i = 0; i < lanes; ++i)
+            partial[i] = first[i];
+        for (first += lanes; static_cast<std::size_t>(last - first) >= lanes;
+             first += lanes) {
+            for (std::size_t i = 0; i < lanes; ++i)
+                partial[i] = operation(partial[i], first[i]);
+        }
+        init = operation(init, fold_lanes(partial, operation));
+    }
+    for (; first != last; ++first)
+        init = operation(init, *first);
+    return init;
+}
+
+// smallest and largest element of a non empty range
+template<class T>
+[[gnu::always_inline]] inline void
+block_minmax(const T *first, const T *last, T &min, T &max)
+{
+    constexpr auto lanes = reduce_lanes<T>;
+    min = max = *first;
+    if (static_cast<std::size_t>(last - first) >= lanes) {
+        T low[lanes], high[lanes];
+        for (std::size_t i = 0; i < lanes; ++i)
+            low[i] = high[i] = first[i];
+        for (first += lanes; static_cast<std::size_t>(last - first) >= lanes;
+             first += lanes) {
+            for (std::size_t i = 0; i < lanes; ++i) {
+                low[i] = first[i] < low[i] ? first[i] : low[i];
+                high[i] = high[i] < first[i] ? first[i] : high[i];
+            }
+        }
+        min = fold_lanes(low, dacal::minimum<T>());
+        max = fold_lanes(high, dacal::maximum<T>());
+    }
+    for (; first != last; ++first) {
+        min = *first < min ? *first : min;
+        max = max < *first ? *first : max;
+    }
+}
+
+template<class T>
+[[gnu::always_inline]] inline T
+block_inner_product(const T *first1, const T *last1, const T *first2, T init)
+{
+    constexpr auto lanes = reduce_lanes<T>;
+    if (static_cast<std::size_t>(last1 - first1) >= lanes) {
+        T partial[lanes]{};
+        for (; static_cast<std::size_t>(last1 - first1) >= lanes;
+             first1 += lanes, first2 += lanes) {
+            for (std::size_t i = 0; i < lanes; ++i)
+                partial[i] += first1[i] * first2[i];
+        }
+        init += fold_lanes(partial, dacal::plus<T>());
+    }
+    for (; first1 != last1; ++first1, ++first2)
+        init += *first1 * *first2;
+    return init;
+}
+
+// sum of [low, high) in lanes with a fixed layout, so every instruction set
+// rounds alike
+template<class T, class Iterator>
+[[gnu::always_inline]] inline T
+sum_block(Iterator array, std::size_t low, std::size_t high)
+{
+    constexpr auto lanes = reduce_lanes<T>;
+    T partial[lanes]{};
+    for (; high - low >= lanes; low += lanes) {
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+            partial[lane] += array[low + lane];
+    }
+    for (std::size_t lane = 0; low < high; ++low, ++lane)
+        partial[lane] += array[low];
+    return fold_lanes(partial, dacal::plus<T>());
+}
+
+// adds value to sum, keeping the rounding error in compensation. Neumaier's
+// variant of kahan summation, it also holds when value outweighs the sum.
+// Needs strict floating point, -ffast-math folds the compensation away
+template<class T>
+[[gnu::always_inline]] inline void
+neumaier_add(T &sum, T &compensation, T value)
+{
+    auto total = sum + value;
+    compensation += std::abs(sum) >= std::abs(value) ? (sum - total) + value
+                                                     : (value - total) + sum;
+    sum = total;
+}
+
+template<class T>
+[[gnu::always_inline]] inline T
+block_kahan_sum(const T *first, const T *last, T init)
+{
+    constexpr auto lanes = reduce_lanes<T>;
+    T sum = init, compensation{};
+    if (static_cast<std::size_t>(last - first) >= lanes) {
+        T partial[lanes]{}, error[lanes]{};
+        for (; static_cast<std::size_t>(last - first) >= lanes;
+             first += lanes) {
+            for (std::size_t i = 0; i < lanes; ++i)
+                neumaier_add(partial[i], error[i], first[i]);
+        }
+        for (std::size_t i = 0; i < lanes; ++i) {
+            neumaier_add(sum, compensation, partial[i]);
+            compensation += error[i];
+        }
+    }
+    for (; first != last; ++first)
+        neumaier_add(sum, compensation, *first);
+    return sum + compensation;
+}
+
+#if defined(DACAL_SIMD_X86)
+template<class T, class Operation>
+[[gnu::target("avx2")]] T avx2_reduce(
+    const T *first, const T *last, T init, const Operation &operation)
+{
+    return block_reduce(first, last, init, operation);
+}
+
+template<class T>
+[[gnu::target("avx2")]] void
+avx2_minmax(const T *first, const T *last, T &min, T &max)
+{
+    block_minmax(first, last, min, max);
+}
+
+template<class T>
+[[gnu::target("avx2")]] T
+avx2_inner_product(const T *first1, const T *last1, const T *first2, T init)
+{
+    return block_inner_product(first1, last1, first2, init);
+}
+
+template<class T>
+[[gnu::target("avx2")]] T
+avx2_sum_block(const T *array, std::size_t low, std::size_t high)
+{
+    return sum_block<T>(array, low, high);
+}
+
+template<class T>
+[[gnu::target("avx2")]] T
+avx2_kahan_sum(const T *first, const T *last, T init)
+{
+    return block_kahan_sum(first, last, init);
+}
+
+template<class T, class Operation>
+[[gnu::target("avx512f,avx512bw")]] T avx512_reduce(
+    const T *first, const T *last, T init, const Operation &operation)
+{
+    return block_reduce(first, last, init, operation);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] void
+avx512_minmax(const T *first, const T *last, T &min, T &max)
+{
+    block_minmax(first, last, min, max);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] T
+avx512_inner_product(const T *first1, const T *last1, const T *first2, T init)
+{
+    return block_inner_product(first1, last1, first2, init);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] T
+avx512_sum_block(const T *array, std::size_t low, std::size_t high)
+{
+    return sum_block<T>(array, low, high);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] T
+avx512_kahan_sum(const T *first, const T *last, T init)
+{
+    return block_kahan_sum(first, last, init);
+}
+#endif
+
+template<simd_element T, class Operation>
+T simd_reduce(const T *first, const T *last, T init, const Operation &operation)
+{
+    if constexpr (overflowing_reduction<T, Operation>) {
+        using U = std::make_unsigned_t<T>;
+        using wrapping = std::conditional_t<
+            std::is_same_v<Operation, dacal::plus<T>>,
+            dacal::plus<U>,
+            dacal::multiplies<U>>;
+        return static_cast<T>(simd_reduce<U>(
+            reinterpret_cast<const U *>(first),
+            reinterpret_cast<const U *>(last),
+            static_cast<U>(init),
+            wrapping()));
+    }
+
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_reduce(first, last, init, operation);
+    case simd_level::avx2:
+        return avx2_reduce(first, last, init, operation);
+    default:
+        break;
+    }
+#endif
+    return block_reduce(first, last, init, operation);
+}
+
+template<simd_element T>
+void simd_minmax(const T *first, const T *last, T &min, T &max)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        avx512_minmax(first, last, min, max);
+        return;
+    case simd_level::avx2:
+        avx2_minmax(first, last, min, max);
+        return;
+    default:
+        break;
+    }
+#endif
+    block_minmax(first, last, min, max);
+}
+
+template<simd_element T>
+T simd_inner_product(const T *first1, const T *last1, const T *first2, T init)
+{
+    if constexpr (overflowing_reduction<T, dacal::plus<T>>) {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(simd_inner_product<U>(
+            reinterpret_cast<const U *>(first1),
+            reinterpret_cast<const U *>(last1),
+            reinterpret_cast<const U *>(first2),
+            static_cast<U>(init)));
+    }
+
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_inner_product(first1, last1, first2, init);
+    case simd_level::avx2:
+        return avx2_inner_product(first1, last1, first2, init);
+    default:
+        break;
+    }
+#endif
+    return block_inner_product(first1, last1, first2, init);
+}
+
+template<simd_element T>
+T simd_sum_block(const T *array, std::size_t low, std::size_t high)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_sum_block(array, low, high);
+    case simd_level::avx2:
+        return avx2_sum_block(array, low, high);
+    default:
+        break;
+    }
+#endif
+    return sum_block<T>(array, low, high);
+}
+
+template<simd_element T>
+T simd_kahan_sum(const T *first, const T *last, T init)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_kahan_sum(first, last, init);
+    case simd_level::avx2:
+        return avx2_kahan_sum(first, last, init);
+    default:
+        break;
+    }
+#endif
+    return block_kahan_sum(first, last, init);
+}
+
+/*
+ *  Sums blocks of pairwise_sum_block elements and pairs the block sums like
+ *  a binary counter: the sum of 2^k blocks waits at level k of the stack
+ *  until a second one arrives. The rounding error grows with log n instead
+ *  of n, and only one sum per level is held at a time.
+ **/
+template<class T, class Iterator>
+T pairwise_sum(Iterator array, std::size_t size, T init)
+{
+    constexpr auto block = pairwise_sum_block<T>;
+
+    T levels[sizeof(std::size_t) * 8];
+    std::size_t depth = 0;
+    std::size_t low = 0;
+    for (std::size_t blocks = 0; size - low >= block; ++blocks, low += block) {
+        T sum;
+        if constexpr (std::is_pointer_v<Iterator> && simd_element<T>)
+            sum = simd_sum_block<T>(array, low, low + block);
+        else
+            sum = sum_block<T>(array, low, low + block);
+
+        for (auto pairs = blocks; pairs & 1; pairs >>= 1)
+            sum = levels[--depth] + sum;
+        levels[depth++] = sum;
+    }
+
+    auto sum = sum_block<T>(array, low, size);
+    while (depth > 0)
+        sum = levels[--depth] + sum;
+    return init + sum;
+}
+
+}  // namespace detail
+
+#endif  // DACAL_REDUCTION_HPP
@@ -0,0 +1,113 @@
+#ifndef DACAL_SELECTION_HPP
+#define DACAL_SELECTION_HPP
+
+#include "quick_sort.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace detail {
+// partial_sort keeps a heap of the first k while k is at most
+// size / partial_sort_heap_ratio, above that selecting and then sorting the
+// prefix is cheaper
+constexpr std::size_t partial_sort_heap_ratio = 256;
+
+// moves the middle - low smallest elements of [low, high) into
+// [low, middle) as a heap, its root is the largest of them
+template<class Iterator, class Compare>
+void heap_select(
+    Iterator array,
+    std::size_t low,
+    std::size_t middle,
+    std::size_t high,
+    const Compare &compare)
+{
+    make_heap(array, low, middle, compare);
+    for (auto i = middle; i < high; ++i) {
+        if (compare(array[i], array[low])) {
+            dacal::swap(array[i], array[low]);
+            sift_down(array, low, 0, middle - low, compare);
+        }
+    }
+}
+
+// quickselect with the pivot choice and partitions of introsort; after too
+// many rounds it finishes with heap_select, which bounds the worst case at
+// n log n
+template<class Iterator, class Compare>
+void introselect(
+    Iterator array,
+    std::size_t low,
+    std::size_t high,
+    std::size_t nth,
+    const Compare &compare)
+{
+    using value_type = std::remove_cvref_t<decltype(array[0])>;
+
+    auto depth = 2 * introsort_depth(high - low);
+    auto leftmost = true;
+    while (high - low > insertion_sort_threshold) {
+        if (depth == 0) {
+            heap_select(array, low, nth + 1, high, compare);
+            dacal::swap(array[low], array[nth]);
+            return;
+        }
+        --depth;
+
+        choose_pivot(array, low, high, compare);
+        if (!leftmost && !compare(array[low - 1], array[low])) {
+            auto equal_high = partition_equal(array, low, high, compare);
+            if (nth < equal_high)
+                return;
+            low = equal_high;
+            continue;
+        }
+
+        bool already_partitioned;
+        std::size_t pivot_pos;
+        if constexpr (branchless_sortable<value_type, Compare>) {
+            pivot_pos = partition_right_branchless(
+                array, low, high, compare, already_partitioned);
+        }
+        else {
+            pivot_pos = partition_right(
+                array, low, high, compare, already_partitioned);
+        }
+
+        if (pivot_pos == nth)
+            return;
+        if (nth < pivot_pos) {
+            high = pivot_pos;
+        }
+        else {
+            low = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+    insertion_sort(array, low, high, compare);
+}
+
+template<class Iterator, class Compare>
+void partial_sort(
+    Iterator array,
+    std::size_t middle,
+    std::size_t size,
+    const Compare &compare)
+{
+    if (middle == 0)
+        return;
+
+    if (middle <= size / partial_sort_heap_ratio) {
+        heap_select(array, 0, middle, size, compare);
+        sort_heap(array, 0, middle, compare);
+        return;
+    }
+
+    introselect(array, 0, size, middle - 1, compare);
+    quick_sort(array, middle - 1, compare);
+}
+
+}  // namespace detail
+
+#endif  // DACAL_SELECTION_HPP
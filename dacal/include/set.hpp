@@ -2,6 +2,7 @@
 #define DACAL_SET_HPP
 
 #include "iterator.hpp"
+#include "memory_resource.hpp"
 #include "utils.hpp"
 
 #include <initializer_list>
@@ -25,6 +26,7 @@ public:
         allocator>::template rebind_alloc<detail::rb_tree_node<value_type>>;
 
     [[maybe_unused]] set() = default;
+    [[maybe_unused]] explicit set(const allocator &_alloc);
     [[maybe_unused]] set(const std::initializer_list<T> &_initializer);
     [[maybe_unused]] set(const set &_other);
     [[maybe_unused]] set(set &&_other) noexcept;
@@ -41,6 +43,9 @@ public:
 
     [[maybe_unused]] void insert(const_reference _data);
 
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
+
 private:
     [[maybe_unused]] void _insert(
         detail::rb_tree_node<T> *&_node,
@@ -49,6 +54,7 @@ private:
     [[maybe_unused]] void _fix_insert(detail::rb_tree_node<T> *node);
     [[maybe_unused]] void _rotateRight(detail::rb_tree_node<T> *node);
     [[maybe_unused]] void _rotateLeft(detail::rb_tree_node<T> *node);
+    [[maybe_unused]] void _destroy(detail::rb_tree_node<value_type> *node);
     [[maybe_unused]] detail::rb_tree_node<value_type> *
     _find(detail::rb_tree_node<value_type> *node, const_reference data);
 
@@ -236,7 +242,17 @@ template<class T, class Compare, class Allocator>
 }
 
 template<class T, class Compare, class Allocator>
-[[maybe_unused]] set<T, Compare, Allocator>::set(const set &_other)
+[[maybe_unused]] set<T, Compare, Allocator>::set(const allocator &_alloc) :
+    _allocator(_alloc),
+    _node_allocator(_alloc)
+{}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] set<T, Compare, Allocator>::set(const set &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator)),
+    _node_allocator(_allocator)
 {
     for (set<T, Compare, Allocator>::iterator i = _other.begin();
          i != _other.end();
@@ -246,16 +262,30 @@ template<class T, class Compare, class Allocator>
 }
 
 template<class T, class Compare, class Allocator>
-[[maybe_unused]] set<T, Compare, Allocator>::set(set &&_other) noexcept
+[[maybe_unused]] set<T, Compare, Allocator>::set(set &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator)),
+    _node_allocator(dacal::move(_other._node_allocator))
 {
     this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
 }
 
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] void set<T, Compare, Allocator>::_destroy(
+    detail::rb_tree_node<value_type> *node)
+{
+    if (node == nullptr)
+        return;
+
+    _destroy(node->_left_child);
+    _destroy(node->_right_child);
+    std::allocator_traits<node_allocator>::destroy(_node_allocator, node);
+    std::allocator_traits<node_allocator>::deallocate(_node_allocator, node, 1);
+}
+
 template<class T, class Compare, class Allocator>
 [[maybe_unused]] set<T, Compare, Allocator>::~set()
 {
-    std::allocator_traits<node_allocator>::deallocate(
-        _node_allocator, _root_of_tree, 1);
+    _destroy(_root_of_tree);
 }
 
 template<class T, class Compare, class Allocator>
@@ -263,6 +293,8 @@ template<class T, class Compare, class Allocator>
 set<T, Compare, Allocator>::operator=(const set &_other)
 {
     if (this != &_other) {
+        _destroy(_root_of_tree);
+        _root_of_tree = nullptr;
         for (set<T, Compare, Allocator>::iterator i = _other.begin();
              i != _other.end();
              ++i) {
@@ -276,7 +308,14 @@ template<class T, class Compare, class Allocator>
 [[maybe_unused]] set<T, Compare, Allocator> &
 set<T, Compare, Allocator>::operator=(set &&_other) noexcept
 {
-    this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
+    if (this != &_other) {
+        _destroy(_root_of_tree);
+
+        // the nodes can only be released by the allocator that made them
+        _allocator = _other._allocator;
+        _node_allocator = _other._node_allocator;
+        this->_root_of_tree = dacal::exchange(_other._root_of_tree, nullptr);
+    }
     return *this;
 }
 
@@ -328,6 +367,35 @@ set<T, Compare, Allocator>::insert(set::const_reference _data)
     _fix_insert(new_node);
 }
 
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename set<T, Compare, Allocator>::allocator
+set<T, Compare, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<class T, class Compare, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+set<T, Compare, Allocator>::memory_usage() const
+{
+    std::size_t _count = 0;
+    for (auto i = begin(); i != end(); ++i) {
+        ++_count;
+    }
+
+    return {
+        _count * sizeof(value_type),
+        _count * (sizeof(detail::rb_tree_node<value_type>) -
+                  sizeof(value_type)) +
+            sizeof(*this)};
+}
+
+namespace pmr {
+template<class T, class Compare = dacal::less<T>>
+using set = dacal::set<T, Compare, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace dacal
 
 #endif  // DACAL_SET_HPP
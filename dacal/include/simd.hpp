@@ -0,0 +1,444 @@
+#ifndef DACAL_SIMD_HPP
+#define DACAL_SIMD_HPP
+
+#include "iterator.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DACAL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace detail {
+enum class simd_level
+{
+    scalar = 0,
+    sse2,
+    avx2,
+    avx512
+};
+
+[[maybe_unused]] inline simd_level detect_simd_level()
+{
+#if defined(DACAL_SIMD_X86)
+    // cpuid, plus xgetbv to check the OS saves the wider registers
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return simd_level::avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+    return simd_level::sse2;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+[[maybe_unused]] inline simd_level cpu_simd_level()
+{
+    static const auto level = detect_simd_level();
+    return level;
+}
+
+// element types the kernels can compare a register at a time
+template<class T>
+concept simd_element = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// an iterator range the kernels can scan directly, with a value of the
+// element type to compare against
+template<class Iterator, class T>
+concept simd_range = dacal::ContiguousIterator<Iterator> &&
+    simd_element<typename Iterator::value_type> &&
+    std::is_same_v<std::remove_cv_t<T>, typename Iterator::value_type>;
+
+// the same for a predicate, which has to accept a const element
+template<class Iterator, class Predicate>
+concept simd_predicate_range = dacal::ContiguousIterator<Iterator> &&
+    simd_element<typename Iterator::value_type> &&
+    std::is_invocable_v<const Predicate &,
+                        const typename Iterator::value_type &>;
+
+// elements per block of the predicate kernels; a fixed trip count lets the
+// compiler vectorise the predicate
+template<class T>
+constexpr std::size_t simd_block = 64 / sizeof(T);
+
+template<class T>
+const T *scalar_find(const T *first, const T *last, T value)
+{
+    for (; first != last; ++first) {
+        if (*first == value)
+            return first;
+    }
+    return last;
+}
+
+template<class T>
+std::size_t scalar_count(const T *first, const T *last, T value)
+{
+    std::size_t count = 0;
+    for (; first != last; ++first)
+        count += *first == value;
+    return count;
+}
+
+template<class T, class Predicate>
+[[gnu::always_inline]] inline std::size_t
+block_count_if(const T *first, const T *last, const Predicate &predicate)
+{
+    std::size_t count = 0;
+    for (; static_cast<std::size_t>(last - first) >= simd_block<T>;
+         first += simd_block<T>) {
+        unsigned block = 0;
+        for (std::size_t i = 0; i < simd_block<T>; ++i)
+            block += predicate(first[i]) ? 1 : 0;
+        count += block;
+    }
+    for (; first != last; ++first)
+        count += predicate(*first) ? 1 : 0;
+    return count;
+}
+
+template<class T, class Predicate>
+[[gnu::always_inline]] inline bool
+block_any_of(const T *first, const T *last, const Predicate &predicate)
+{
+    for (; static_cast<std::size_t>(last - first) >= simd_block<T>;
+         first += simd_block<T>) {
+        bool block = false;
+        for (std::size_t i = 0; i < simd_block<T>; ++i)
+            block |= static_cast<bool>(predicate(first[i]));
+        if (block)
+            return true;
+    }
+    for (; first != last; ++first) {
+        if (predicate(*first))
+            return true;
+    }
+    return false;
+}
+
+#if defined(DACAL_SIMD_X86)
+// equality masks of the sse2 and avx2 kernels have one bit per byte, so an
+// element of size n sets n bits; avx512 masks have one bit per element
+
+template<class T>
+__m128i sse2_splat(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+        return _mm_castps_si128(_mm_set1_ps(value));
+    else if constexpr (std::is_same_v<T, double>)
+        return _mm_castpd_si128(_mm_set1_pd(value));
+    else if constexpr (sizeof(T) == 1)
+        return _mm_set1_epi8(static_cast<char>(value));
+    else if constexpr (sizeof(T) == 2)
+        return _mm_set1_epi16(static_cast<short>(value));
+    else if constexpr (sizeof(T) == 4)
+        return _mm_set1_epi32(static_cast<int>(value));
+    else
+        return _mm_set1_epi64x(static_cast<long long>(value));
+}
+
+template<class T>
+unsigned sse2_equal_mask(const T *data, __m128i needle)
+{
+    auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    __m128i equal;
+    if constexpr (std::is_same_v<T, float>) {
+        equal = _mm_castps_si128(_mm_cmpeq_ps(
+            _mm_castsi128_ps(block), _mm_castsi128_ps(needle)));
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        equal = _mm_castpd_si128(_mm_cmpeq_pd(
+            _mm_castsi128_pd(block), _mm_castsi128_pd(needle)));
+    }
+    else if constexpr (sizeof(T) == 1) {
+        equal = _mm_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(T) == 2) {
+        equal = _mm_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(T) == 4) {
+        equal = _mm_cmpeq_epi32(block, needle);
+    }
+    else {
+        // no 64 bit compare before sse4.1, both halves have to match
+        auto halves = _mm_cmpeq_epi32(block, needle);
+        equal = _mm_and_si128(
+            halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    return static_cast<unsigned>(_mm_movemask_epi8(equal));
+}
+
+template<class T>
+const T *sse2_find(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 16 / sizeof(T);
+    auto needle = sse2_splat(value);
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes) {
+        auto mask = sse2_equal_mask(first, needle);
+        if (mask != 0)
+            return first + std::countr_zero(mask) / sizeof(T);
+    }
+    return scalar_find(first, last, value);
+}
+
+template<class T>
+std::size_t sse2_count(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 16 / sizeof(T);
+    auto needle = sse2_splat(value);
+    std::size_t bits = 0;
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes)
+        bits += std::popcount(sse2_equal_mask(first, needle));
+    return bits / sizeof(T) + scalar_count(first, last, value);
+}
+
+template<class T>
+[[gnu::target("avx2")]] __m256i avx2_splat(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+        return _mm256_castps_si256(_mm256_set1_ps(value));
+    else if constexpr (std::is_same_v<T, double>)
+        return _mm256_castpd_si256(_mm256_set1_pd(value));
+    else if constexpr (sizeof(T) == 1)
+        return _mm256_set1_epi8(static_cast<char>(value));
+    else if constexpr (sizeof(T) == 2)
+        return _mm256_set1_epi16(static_cast<short>(value));
+    else if constexpr (sizeof(T) == 4)
+        return _mm256_set1_epi32(static_cast<int>(value));
+    else
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+}
+
+template<class T>
+[[gnu::target("avx2")]] unsigned avx2_equal_mask(const T *data, __m256i needle)
+{
+    auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    __m256i equal;
+    if constexpr (std::is_same_v<T, float>) {
+        equal = _mm256_castps_si256(_mm256_cmp_ps(
+            _mm256_castsi256_ps(block),
+            _mm256_castsi256_ps(needle),
+            _CMP_EQ_OQ));
+    }
+    else if constexpr (std::is_same_v<T, double>) {
+        equal = _mm256_castpd_si256(_mm256_cmp_pd(
+            _mm256_castsi256_pd(block),
+            _mm256_castsi256_pd(needle),
+            _CMP_EQ_OQ));
+    }
+    else if constexpr (sizeof(T) == 1) {
+        equal = _mm256_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(T) == 2) {
+        equal = _mm256_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(T) == 4) {
+        equal = _mm256_cmpeq_epi32(block, needle);
+    }
+    else {
+        equal = _mm256_cmpeq_epi64(block, needle);
+    }
+    return static_cast<unsigned>(_mm256_movemask_epi8(equal));
+}
+
+template<class T>
+[[gnu::target("avx2")]] const T *
+avx2_find(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    auto needle = avx2_splat(value);
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes) {
+        auto mask = avx2_equal_mask(first, needle);
+        if (mask != 0)
+            return first + std::countr_zero(mask) / sizeof(T);
+    }
+    return scalar_find(first, last, value);
+}
+
+template<class T>
+[[gnu::target("avx2")]] std::size_t
+avx2_count(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    auto needle = avx2_splat(value);
+    std::size_t bits = 0;
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes)
+        bits += std::popcount(avx2_equal_mask(first, needle));
+    return bits / sizeof(T) + scalar_count(first, last, value);
+}
+
+template<class T, class Predicate>
+[[gnu::target("avx2")]] std::size_t
+avx2_count_if(const T *first, const T *last, const Predicate &predicate)
+{
+    return block_count_if(first, last, predicate);
+}
+
+template<class T, class Predicate>
+[[gnu::target("avx2")]] bool
+avx2_any_of(const T *first, const T *last, const Predicate &predicate)
+{
+    return block_any_of(first, last, predicate);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] __m512i avx512_splat(T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+        return _mm512_castps_si512(_mm512_set1_ps(value));
+    else if constexpr (std::is_same_v<T, double>)
+        return _mm512_castpd_si512(_mm512_set1_pd(value));
+    else if constexpr (sizeof(T) == 1)
+        return _mm512_set1_epi8(static_cast<char>(value));
+    else if constexpr (sizeof(T) == 2)
+        return _mm512_set1_epi16(static_cast<short>(value));
+    else if constexpr (sizeof(T) == 4)
+        return _mm512_set1_epi32(static_cast<int>(value));
+    else
+        return _mm512_set1_epi64(static_cast<long long>(value));
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] uint64_t
+avx512_equal_mask(const T *data, __m512i needle)
+{
+    auto block = _mm512_loadu_si512(data);
+    if constexpr (std::is_same_v<T, float>)
+        return _mm512_cmp_ps_mask(
+            _mm512_castsi512_ps(block),
+            _mm512_castsi512_ps(needle),
+            _CMP_EQ_OQ);
+    else if constexpr (std::is_same_v<T, double>)
+        return _mm512_cmp_pd_mask(
+            _mm512_castsi512_pd(block),
+            _mm512_castsi512_pd(needle),
+            _CMP_EQ_OQ);
+    else if constexpr (sizeof(T) == 1)
+        return _mm512_cmpeq_epi8_mask(block, needle);
+    else if constexpr (sizeof(T) == 2)
+        return _mm512_cmpeq_epi16_mask(block, needle);
+    else if constexpr (sizeof(T) == 4)
+        return _mm512_cmpeq_epi32_mask(block, needle);
+    else
+        return _mm512_cmpeq_epi64_mask(block, needle);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] const T *
+avx512_find(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    auto needle = avx512_splat(value);
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes) {
+        auto mask = avx512_equal_mask(first, needle);
+        if (mask != 0)
+            return first + std::countr_zero(mask);
+    }
+    return scalar_find(first, last, value);
+}
+
+template<class T>
+[[gnu::target("avx512f,avx512bw")]] std::size_t
+avx512_count(const T *first, const T *last, T value)
+{
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    auto needle = avx512_splat(value);
+    std::size_t count = 0;
+    for (; static_cast<std::size_t>(last - first) >= lanes; first += lanes)
+        count += std::popcount(avx512_equal_mask(first, needle));
+    return count + scalar_count(first, last, value);
+}
+
+template<class T, class Predicate>
+[[gnu::target("avx512f,avx512bw")]] std::size_t
+avx512_count_if(const T *first, const T *last, const Predicate &predicate)
+{
+    return block_count_if(first, last, predicate);
+}
+
+template<class T, class Predicate>
+[[gnu::target("avx512f,avx512bw")]] bool
+avx512_any_of(const T *first, const T *last, const Predicate &predicate)
+{
+    return block_any_of(first, last, predicate);
+}
+#endif
+
+template<simd_element T>
+const T *simd_find(const T *first, const T *last, T value)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_find(first, last, value);
+    case simd_level::avx2:
+        return avx2_find(first, last, value);
+    case simd_level::sse2:
+        return sse2_find(first, last, value);
+    default:
+        break;
+    }
+#endif
+    return scalar_find(first, last, value);
+}
+
+template<simd_element T>
+std::size_t simd_count(const T *first, const T *last, T value)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_count(first, last, value);
+    case simd_level::avx2:
+        return avx2_count(first, last, value);
+    case simd_level::sse2:
+        return sse2_count(first, last, value);
+    default:
+        break;
+    }
+#endif
+    return scalar_count(first, last, value);
+}
+
+template<simd_element T, class Predicate>
+std::size_t
+simd_count_if(const T *first, const T *last, const Predicate &predicate)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_count_if(first, last, predicate);
+    case simd_level::avx2:
+        return avx2_count_if(first, last, predicate);
+    default:
+        break;
+    }
+#endif
+    return block_count_if(first, last, predicate);
+}
+
+template<simd_element T, class Predicate>
+bool simd_any_of(const T *first, const T *last, const Predicate &predicate)
+{
+#if defined(DACAL_SIMD_X86)
+    switch (cpu_simd_level()) {
+    case simd_level::avx512:
+        return avx512_any_of(first, last, predicate);
+    case simd_level::avx2:
+        return avx2_any_of(first, last, predicate);
+    default:
+        break;
+    }
+#endif
+    return block_any_of(first, last, predicate);
+}
+
+}  // namespace detail
+
+#endif  // DACAL_SIMD_HPP
@@ -10,6 +10,10 @@ class [[maybe_unused]] stack
 public:
     [[maybe_unused]] stack() = default;
 
+    template<class Alloc>
+    [[maybe_unused]] explicit stack(const Alloc &_alloc) : _container(_alloc)
+    {}
+
     [[maybe_unused]] void push(const T &data)
     {
         _container.push_back(data);
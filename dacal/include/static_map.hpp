@@ -0,0 +1,235 @@
+#ifndef DACAL_STATIC_MAP_HPP
+#define DACAL_STATIC_MAP_HPP
+
+#include "pair.hpp"
+#include "utils.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace detail {
+template<class Key>
+[[maybe_unused]] constexpr auto static_map_key(const Key &_key)
+{
+    if constexpr (std::is_convertible_v<Key, std::string_view>) {
+        return std::string_view(_key);
+    }
+    else {
+        return _key;
+    }
+}
+
+template<class Key>
+[[maybe_unused]] constexpr uint64_t static_map_hash(const Key &_key)
+{
+    auto _view = static_map_key(_key);
+    if constexpr (std::is_same_v<decltype(_view), std::string_view>) {
+        // FNV-1a
+        uint64_t _hash = 14695981039346656037ULL;
+        for (auto _c : _view) {
+            _hash ^= static_cast<unsigned char>(_c);
+            _hash *= 1099511628211ULL;
+        }
+        return hash_mix(_hash);
+    }
+    else if constexpr (std::is_floating_point_v<decltype(_view)>) {
+        static_assert(
+            sizeof(_view) == 4 || sizeof(_view) == 8,
+            "static_map supports float and double keys only!");
+        using bits = std::conditional_t<sizeof(_view) == 4, uint32_t, uint64_t>;
+        // the bits rather than the truncated value, with -0.0 equal to 0.0
+        auto _value = _view == 0 ? decltype(_view){} : _view;
+        return hash_mix(static_cast<uint64_t>(std::bit_cast<bits>(_value)));
+    }
+    else {
+        return hash_mix(static_cast<uint64_t>(_view));
+    }
+}
+
+// displacements a bucket tries before construction gives up
+constexpr int64_t static_map_max_displacement = 1 << 16;
+
+// never evaluated on success; the constructor is consteval, so calling one
+// of these turns a construction failure into a compile error that names it
+[[maybe_unused]] inline void static_map_duplicate_key() {}
+[[maybe_unused]] inline void static_map_hash_collision() {}
+[[maybe_unused]] inline void static_map_no_displacement() {}
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Immutable map whose perfect hash is computed at compile time using the
+ *  CHD (compress, hash, displace) scheme. Keys are hashed once; the hash
+ *  selects a bucket whose displacement gives the slot, so a lookup is one
+ *  hash, one probe and one compare.
+ *
+ *  Construction is consteval: duplicate keys, and distinct keys whose 64 bit
+ *  hashes collide, fail to compile instead of failing at run time.
+ **/
+template<class Key, class T, std::size_t N>
+class [[maybe_unused]] static_map
+{
+    static_assert(N > 0, "static_map requires at least one entry!");
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = dacal::pair<key_type, mapped_type>;
+
+    [[maybe_unused]] consteval explicit static_map(
+        const value_type (&_entries)[N]);
+
+    [[maybe_unused]] [[nodiscard]] constexpr const mapped_type *
+    find(const key_type &_key) const;
+    [[maybe_unused]] [[nodiscard]] constexpr bool
+    contains(const key_type &_key) const;
+    [[maybe_unused]] [[nodiscard]] constexpr std::size_t size() const;
+
+private:
+    static constexpr std::size_t _bucket_count = N / 2 + 1;
+
+    [[maybe_unused]] static constexpr std::size_t
+    _slot(uint64_t _hash, int64_t _displacement);
+
+    value_type _slots[N]{};
+    int64_t _displacements[_bucket_count]{};
+};
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] constexpr std::size_t
+static_map<Key, T, N>::_slot(uint64_t _hash, int64_t _displacement)
+{
+    // negative displacements encode the slot of a single-key bucket directly
+    if (_displacement < 0)
+        return static_cast<std::size_t>(-_displacement - 1);
+    return detail::hash_mix(_hash + static_cast<uint64_t>(_displacement)) % N;
+}
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] consteval static_map<Key, T, N>::static_map(
+    const value_type (&_entries)[N])
+{
+    uint64_t _hashes[N]{};
+    std::size_t _bucket_size[_bucket_count]{};
+    std::size_t _bucket_offset[_bucket_count + 1]{};
+    std::size_t _members[N]{};
+    bool _occupied[N]{};
+
+    for (std::size_t i = 0; i < N; ++i) {
+        _hashes[i] = detail::static_map_hash(_entries[i]._first);
+        ++_bucket_size[_hashes[i] % _bucket_count];
+    }
+
+    std::size_t _max_bucket_size = 0;
+    for (std::size_t b = 0; b < _bucket_count; ++b) {
+        _bucket_offset[b + 1] = _bucket_offset[b] + _bucket_size[b];
+        if (_bucket_size[b] > _max_bucket_size)
+            _max_bucket_size = _bucket_size[b];
+    }
+
+    std::size_t _fill[_bucket_count]{};
+    for (std::size_t i = 0; i < N; ++i) {
+        auto _bucket = _hashes[i] % _bucket_count;
+        _members[_bucket_offset[_bucket] + _fill[_bucket]++] = i;
+    }
+
+    // place the largest buckets first, they are the hardest to displace
+    for (auto _size = _max_bucket_size; _size > 1; --_size) {
+        for (std::size_t b = 0; b < _bucket_count; ++b) {
+            if (_bucket_size[b] != _size)
+                continue;
+
+            // equal hashes land in the same slot under every displacement
+            auto _first = _members + _bucket_offset[b];
+            for (std::size_t i = 0; i < _size; ++i) {
+                for (std::size_t j = i + 1; j < _size; ++j) {
+                    if (_hashes[_first[i]] != _hashes[_first[j]])
+                        continue;
+                    if (detail::static_map_key(_entries[_first[i]]._first) ==
+                        detail::static_map_key(_entries[_first[j]]._first))
+                        detail::static_map_duplicate_key();
+                    else
+                        detail::static_map_hash_collision();
+                }
+            }
+
+            for (int64_t d = 0;; ++d) {
+                if (d == detail::static_map_max_displacement)
+                    detail::static_map_no_displacement();
+
+                bool _placed = true;
+                for (std::size_t i = 0; i < _size && _placed; ++i) {
+                    auto _s = _slot(_hashes[_first[i]], d);
+                    if (_occupied[_s]) {
+                        _placed = false;
+                    }
+                    for (std::size_t j = 0; j < i && _placed; ++j) {
+                        if (_slot(_hashes[_first[j]], d) == _s)
+                            _placed = false;
+                    }
+                }
+
+                if (_placed) {
+                    for (std::size_t i = 0; i < _size; ++i) {
+                        auto _s = _slot(_hashes[_first[i]], d);
+                        _occupied[_s] = true;
+                        _slots[_s] = _entries[_first[i]];
+                    }
+                    _displacements[b] = d;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::size_t _free_slot = 0;
+    for (std::size_t b = 0; b < _bucket_count; ++b) {
+        if (_bucket_size[b] != 1)
+            continue;
+
+        while (_occupied[_free_slot])
+            ++_free_slot;
+        _occupied[_free_slot] = true;
+        _slots[_free_slot] = _entries[_members[_bucket_offset[b]]];
+        _displacements[b] = -static_cast<int64_t>(_free_slot) - 1;
+    }
+}
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] [[nodiscard]] constexpr const T *
+static_map<Key, T, N>::find(const key_type &_key) const
+{
+    auto _hash = detail::static_map_hash(_key);
+    auto &_entry = _slots[_slot(_hash, _displacements[_hash % _bucket_count])];
+    if (detail::static_map_key(_entry._first) == detail::static_map_key(_key))
+        return &_entry._second;
+    return nullptr;
+}
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] [[nodiscard]] constexpr bool
+static_map<Key, T, N>::contains(const key_type &_key) const
+{
+    return find(_key) != nullptr;
+}
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] [[nodiscard]] constexpr std::size_t
+static_map<Key, T, N>::size() const
+{
+    return N;
+}
+
+template<class Key, class T, std::size_t N>
+[[maybe_unused]] consteval dacal::static_map<Key, T, N>
+make_static_map(const dacal::pair<Key, T> (&_entries)[N])
+{
+    return dacal::static_map<Key, T, N>(_entries);
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_STATIC_MAP_HPP
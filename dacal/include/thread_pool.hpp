@@ -0,0 +1,193 @@
+#ifndef DACAL_THREAD_POOL_HPP
+#define DACAL_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dacal {
+class thread_pool;
+}  // namespace dacal
+
+namespace detail {
+// the pool the current thread works for, nullptr outside any pool
+[[maybe_unused]] inline const dacal::thread_pool *&current_thread_pool()
+{
+    static thread_local const dacal::thread_pool *pool = nullptr;
+    return pool;
+}
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Fixed set of worker threads for fork-join work. run(n, func) calls
+ *  func(0) .. func(n - 1) spread over the workers and the calling thread
+ *  and returns once all calls did. One job runs at a time; a job that
+ *  calls run() on its own pool executes the inner job inline. A call that
+ *  throws cancels the calls not started yet, and run() rethrows the first
+ *  exception once the started ones returned.
+ **/
+class [[maybe_unused]] thread_pool
+{
+public:
+    // the calling thread counts, a pool of n threads starts n - 1 workers
+    [[maybe_unused]] explicit thread_pool(
+        std::size_t _threads = std::thread::hardware_concurrency());
+    [[maybe_unused]] thread_pool(const thread_pool &_other) = delete;
+    [[maybe_unused]] ~thread_pool();
+
+    [[maybe_unused]] thread_pool &operator=(const thread_pool &_other) = delete;
+
+    template<class UnaryFunction>
+    [[maybe_unused]] void run(std::size_t _tasks, const UnaryFunction &_func);
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+
+private:
+    [[maybe_unused]] void _work();
+    [[maybe_unused]] void _drain();
+
+    std::unique_ptr<std::thread[]> _workers;
+    std::size_t _worker_count;
+
+    std::mutex _run_mutex;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    bool _stopping{};
+
+    // the job being run, type erased so the workers need no template
+    const void *_job{};
+    void (*_invoke)(const void *, std::size_t){};
+    std::size_t _task_count{};
+    std::size_t _generation{};
+    std::size_t _active{};
+    std::atomic<std::size_t> _next{};
+    std::exception_ptr _error;
+};
+
+[[maybe_unused]] inline thread_pool::thread_pool(std::size_t _threads) :
+    _worker_count(_threads > 1 ? _threads - 1 : 0)
+{
+    _workers.reset(new std::thread[_worker_count]);
+    for (std::size_t i = 0; i < _worker_count; ++i)
+        _workers[i] = std::thread([this] { _work(); });
+}
+
+[[maybe_unused]] inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::size_t i = 0; i < _worker_count; ++i)
+        _workers[i].join();
+}
+
+template<class UnaryFunction>
+[[maybe_unused]] void
+thread_pool::run(std::size_t _tasks, const UnaryFunction &_func)
+{
+    if (_tasks == 0)
+        return;
+    if (_tasks == 1 || _worker_count == 0 ||
+        detail::current_thread_pool() == this) {
+        for (std::size_t i = 0; i < _tasks; ++i)
+            _func(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> _run_lock(_run_mutex);
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _job = &_func;
+        _invoke = [](const void *job, std::size_t task) {
+            (*static_cast<const UnaryFunction *>(job))(task);
+        };
+        _task_count = _tasks;
+        _next.store(0, std::memory_order_relaxed);
+        _active = _worker_count;
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    auto _previous = detail::current_thread_pool();
+    detail::current_thread_pool() = this;
+    _drain();
+    detail::current_thread_pool() = _previous;
+
+    // the workers hold on to _func until they are done with this job
+    std::unique_lock<std::mutex> _lock(_mutex);
+    _done.wait(_lock, [this] { return _active == 0; });
+    if (_error) {
+        auto _thrown = _error;
+        _error = nullptr;
+        std::rethrow_exception(_thrown);
+    }
+}
+
+[[maybe_unused]] [[nodiscard]] inline std::size_t thread_pool::size() const
+{
+    return _worker_count + 1;
+}
+
+[[maybe_unused]] inline void thread_pool::_work()
+{
+    detail::current_thread_pool() = this;
+
+    std::size_t _seen = 0;
+    std::unique_lock<std::mutex> _lock(_mutex);
+    for (;;) {
+        _wake.wait(
+            _lock, [&] { return _stopping || _generation != _seen; });
+        if (_stopping)
+            return;
+        _seen = _generation;
+
+        _lock.unlock();
+        _drain();
+        _lock.lock();
+
+        if (--_active == 0)
+            _done.notify_one();
+    }
+}
+
+[[maybe_unused]] inline void thread_pool::_drain()
+{
+    // tasks are handed out one at a time, so uneven tasks balance out
+    for (auto _task = _next.fetch_add(1, std::memory_order_relaxed);
+         _task < _task_count;
+         _task = _next.fetch_add(1, std::memory_order_relaxed)) {
+        try {
+            _invoke(_job, _task);
+        }
+        catch (...) {
+            {
+                std::lock_guard<std::mutex> _lock(_mutex);
+                if (!_error)
+                    _error = std::current_exception();
+            }
+            // no task is handed out from here on
+            _next.store(_task_count, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// shared pool with one thread per hardware thread, started on first use
+[[maybe_unused]] inline thread_pool &default_thread_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+}  // namespace dacal
+
+#endif  // DACAL_THREAD_POOL_HPP
@@ -0,0 +1,611 @@
+#ifndef DACAL_TIM_SORT_HPP
+#define DACAL_TIM_SORT_HPP
+
+#include "quick_sort.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace dacal {
+/*
+ *  Scratch memory for stable_sort, from the allocator of the caller's
+ *  choice. It only grows, so one buffer kept next to a container serves
+ *  every sort of it without allocating again. Holds no live elements
+ *  between sorts.
+ **/
+template<class T, class Allocator = std::allocator<T>>
+class [[maybe_unused]] stable_sort_buffer
+{
+public:
+    using value_type = T;
+    using allocator = Allocator;
+
+    [[maybe_unused]] stable_sort_buffer() = default;
+    [[maybe_unused]] explicit stable_sort_buffer(const allocator &_alloc) :
+        _allocator(_alloc)
+    {}
+    [[maybe_unused]] stable_sort_buffer(
+        const stable_sort_buffer &_other) = delete;
+    [[maybe_unused]] ~stable_sort_buffer()
+    {
+        std::allocator_traits<allocator>::deallocate(
+            _allocator, _data, _capacity);
+    }
+
+    [[maybe_unused]] stable_sort_buffer &
+    operator=(const stable_sort_buffer &_other) = delete;
+
+    // storage for at least _n elements, uninitialised
+    [[maybe_unused]] [[nodiscard]] T *reserve(std::size_t _n)
+    {
+        if (_n > _capacity) {
+            auto _new_capacity = _n > 2 * _capacity ? _n : 2 * _capacity;
+            std::allocator_traits<allocator>::deallocate(
+                _allocator, _data, _capacity);
+            _data = nullptr;
+            _capacity = 0;
+
+            _data = std::allocator_traits<allocator>::allocate(
+                _allocator, _new_capacity);
+            _capacity = _new_capacity;
+        }
+        return _data;
+    }
+
+    [[maybe_unused]] [[nodiscard]] std::size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const
+    {
+        return _allocator;
+    }
+
+private:
+    allocator _allocator{};
+    T *_data{};
+    std::size_t _capacity{};
+};
+
+}  // namespace dacal
+
+namespace detail {
+// shorter inputs are insertion sorted, longer ones split into runs of
+// between half and all of this
+constexpr std::size_t tim_sort_min_merge = 64;
+
+// consecutive wins by one side before a merge switches to galloping
+constexpr std::size_t tim_sort_min_gallop = 7;
+
+// run lengths on the stack grow at least like the Fibonacci numbers, this
+// is more than any std::size_t input can need
+constexpr std::size_t tim_sort_max_runs = 96;
+
+constexpr std::size_t tim_sort_min_run(std::size_t size)
+{
+    // size / 2^k rounded up, for some k that brings it into
+    // [min_merge / 2, min_merge]
+    std::size_t rest = 0;
+    while (size >= tim_sort_min_merge) {
+        rest |= size & 1;
+        size >>= 1;
+    }
+    return size + rest;
+}
+
+// end of the run starting at low; a strictly descending run is reversed,
+// non-strict would break stability
+template<class Iterator, class Compare>
+std::size_t tim_sort_count_run(
+    Iterator array, std::size_t low, std::size_t high, const Compare &compare)
+{
+    auto run_high = low + 1;
+    if (run_high == high)
+        return run_high;
+
+    if (compare(array[run_high++], array[low])) {
+        while (run_high < high && compare(array[run_high], array[run_high - 1]))
+            ++run_high;
+        for (auto first = low, last = run_high - 1; first < last;
+             ++first, --last)
+            dacal::swap(array[first], array[last]);
+    }
+    else {
+        while (run_high < high &&
+               !compare(array[run_high], array[run_high - 1]))
+            ++run_high;
+    }
+    return run_high;
+}
+
+// number of elements of source[base, base + size) less than key; the search
+// gallops out from hint before bisecting
+template<class Source, class T, class Compare>
+std::size_t gallop_left(
+    const T &key,
+    Source source,
+    std::size_t base,
+    std::size_t size,
+    std::size_t hint,
+    const Compare &compare)
+{
+    std::size_t last_offset = 0, offset = 1, low, high;
+    if (compare(source[base + hint], key)) {
+        auto max_offset = size - hint;
+        while (offset < max_offset &&
+               compare(source[base + hint + offset], key)) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        if (offset > max_offset)
+            offset = max_offset;
+        low = hint + last_offset + 1;
+        high = hint + offset;
+    }
+    else {
+        auto max_offset = hint + 1;
+        while (offset < max_offset &&
+               !compare(source[base + hint - offset], key)) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        if (offset > max_offset)
+            offset = max_offset;
+        low = hint + 1 - offset;
+        high = hint - last_offset;
+    }
+
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (compare(source[base + middle], key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+// number of elements of source[base, base + size) not greater than key
+template<class Source, class T, class Compare>
+std::size_t gallop_right(
+    const T &key,
+    Source source,
+    std::size_t base,
+    std::size_t size,
+    std::size_t hint,
+    const Compare &compare)
+{
+    std::size_t last_offset = 0, offset = 1, low, high;
+    if (compare(key, source[base + hint])) {
+        auto max_offset = hint + 1;
+        while (offset < max_offset &&
+               compare(key, source[base + hint - offset])) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        if (offset > max_offset)
+            offset = max_offset;
+        low = hint + 1 - offset;
+        high = hint - last_offset;
+    }
+    else {
+        auto max_offset = size - hint;
+        while (offset < max_offset &&
+               !compare(key, source[base + hint + offset])) {
+            last_offset = offset;
+            offset = offset * 2 + 1;
+        }
+        if (offset > max_offset)
+            offset = max_offset;
+        low = hint + last_offset + 1;
+        high = hint + offset;
+    }
+
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (compare(key, source[base + middle]))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+template<class Iterator, class Buffer, class Compare>
+class tim_sort_state
+{
+public:
+    using value_type = typename Buffer::value_type;
+
+    tim_sort_state(Iterator array, Buffer &buffer, const Compare &compare) :
+        _array(array), _buffer(buffer), _compare(compare)
+    {}
+
+    void sort(std::size_t size);
+
+private:
+    void _push_run(std::size_t base, std::size_t size);
+    void _merge_collapse();
+    void _merge_force_collapse();
+    void _merge_at(std::size_t run);
+
+    // of the two merges the one that copies out the shorter run is used
+    void _merge_low(
+        std::size_t base1,
+        std::size_t size1,
+        std::size_t base2,
+        std::size_t size2);
+    void _merge_high(
+        std::size_t base1,
+        std::size_t size1,
+        std::size_t base2,
+        std::size_t size2);
+    void _gallop_low(
+        value_type *scratch,
+        std::size_t &cursor1,
+        std::size_t &size1,
+        std::size_t &cursor2,
+        std::size_t &size2,
+        std::size_t &destination);
+    void _gallop_high(
+        value_type *scratch,
+        std::size_t base1,
+        std::size_t &size1,
+        std::size_t &size2);
+
+    value_type *_scratch(std::size_t size);
+    void _release(value_type *scratch, std::size_t size);
+
+    Iterator _array;
+    Buffer &_buffer;
+    const Compare &_compare;
+    std::size_t _min_gallop = tim_sort_min_gallop;
+    std::size_t _run_count = 0;
+    std::size_t _run_base[tim_sort_max_runs];
+    std::size_t _run_size[tim_sort_max_runs];
+};
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::sort(std::size_t size)
+{
+    if (size < 2)
+        return;
+    if (size < tim_sort_min_merge) {
+        insertion_sort(_array, 0, size, _compare);
+        return;
+    }
+
+    auto min_run = tim_sort_min_run(size);
+    for (std::size_t low = 0; low < size;) {
+        auto high = tim_sort_count_run(_array, low, size, _compare);
+
+        // short natural runs are extended to min_run
+        if (high - low < min_run) {
+            auto forced = size - low < min_run ? size : low + min_run;
+            insertion_sort(_array, low, forced, _compare);
+            high = forced;
+        }
+
+        _push_run(low, high - low);
+        _merge_collapse();
+        low = high;
+    }
+    _merge_force_collapse();
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_push_run(
+    std::size_t base, std::size_t size)
+{
+    _run_base[_run_count] = base;
+    _run_size[_run_count] = size;
+    ++_run_count;
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_merge_collapse()
+{
+    // keeps size[i - 2] > size[i - 1] + size[i] and size[i - 1] > size[i]
+    // for the top four runs, checking only three is not enough to keep the
+    // stack bounded
+    while (_run_count > 1) {
+        auto n = _run_count - 2;
+        if ((n > 0 && _run_size[n - 1] <= _run_size[n] + _run_size[n + 1]) ||
+            (n > 1 && _run_size[n - 2] <= _run_size[n - 1] + _run_size[n])) {
+            if (_run_size[n - 1] < _run_size[n + 1])
+                --n;
+        }
+        else if (_run_size[n] > _run_size[n + 1]) {
+            break;
+        }
+        _merge_at(n);
+    }
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_merge_force_collapse()
+{
+    while (_run_count > 1) {
+        auto n = _run_count - 2;
+        if (n > 0 && _run_size[n - 1] < _run_size[n + 1])
+            --n;
+        _merge_at(n);
+    }
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_merge_at(std::size_t run)
+{
+    auto base1 = _run_base[run], size1 = _run_size[run];
+    auto base2 = _run_base[run + 1], size2 = _run_size[run + 1];
+
+    _run_size[run] = size1 + size2;
+    if (run == _run_count - 3) {
+        _run_base[run + 1] = _run_base[run + 2];
+        _run_size[run + 1] = _run_size[run + 2];
+    }
+    --_run_count;
+
+    // the head of the first run and the tail of the second are already in
+    // place
+    auto skipped =
+        gallop_right(_array[base2], _array, base1, size1, 0, _compare);
+    base1 += skipped;
+    size1 -= skipped;
+    if (size1 == 0)
+        return;
+
+    size2 = gallop_left(
+        _array[base1 + size1 - 1], _array, base2, size2, size2 - 1, _compare);
+    if (size2 == 0)
+        return;
+
+    if (size1 <= size2)
+        _merge_low(base1, size1, base2, size2);
+    else
+        _merge_high(base1, size1, base2, size2);
+}
+
+template<class Iterator, class Buffer, class Compare>
+auto tim_sort_state<Iterator, Buffer, Compare>::_scratch(std::size_t size)
+    -> value_type *
+{
+    return _buffer.reserve(size);
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_release(
+    value_type *scratch, std::size_t size)
+{
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        for (std::size_t i = 0; i < size; ++i)
+            scratch[i].~value_type();
+    }
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_merge_low(
+    std::size_t base1,
+    std::size_t size1,
+    std::size_t base2,
+    std::size_t size2)
+{
+    // the first run moves out and is merged back from the left
+    auto scratch = _scratch(size1);
+    for (std::size_t i = 0; i < size1; ++i)
+        ::new (static_cast<void *>(scratch + i))
+            value_type(dacal::move(_array[base1 + i]));
+    auto copied = size1;
+
+    std::size_t cursor1 = 0, cursor2 = base2, destination = base1;
+    _array[destination++] = dacal::move(_array[cursor2++]);
+    if (--size2 != 0 && size1 > 1)
+        _gallop_low(scratch, cursor1, size1, cursor2, size2, destination);
+
+    if (size1 == 1) {
+        for (std::size_t i = 0; i < size2; ++i)
+            _array[destination + i] = dacal::move(_array[cursor2 + i]);
+        _array[destination + size2] = dacal::move(scratch[cursor1]);
+    }
+    else {
+        for (std::size_t i = 0; i < size1; ++i)
+            _array[destination + i] = dacal::move(scratch[cursor1 + i]);
+    }
+    _release(scratch, copied);
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_gallop_low(
+    value_type *scratch,
+    std::size_t &cursor1,
+    std::size_t &size1,
+    std::size_t &cursor2,
+    std::size_t &size2,
+    std::size_t &destination)
+{
+    // returns with size1 == 1 or size2 == 0, or size1 == 0 for a comparison
+    // that is not a strict weak order
+    for (;;) {
+        std::size_t wins1 = 0, wins2 = 0;
+
+        // one element at a time until one side keeps winning
+        do {
+            if (_compare(_array[cursor2], scratch[cursor1])) {
+                _array[destination++] = dacal::move(_array[cursor2++]);
+                ++wins2;
+                wins1 = 0;
+                if (--size2 == 0)
+                    return;
+            }
+            else {
+                _array[destination++] = dacal::move(scratch[cursor1++]);
+                ++wins1;
+                wins2 = 0;
+                if (--size1 == 1)
+                    return;
+            }
+        } while ((wins1 | wins2) < _min_gallop);
+
+        // then in blocks found by galloping, for as long as that pays
+        do {
+            wins1 = gallop_right(
+                _array[cursor2], scratch, cursor1, size1, 0, _compare);
+            for (std::size_t i = 0; i < wins1; ++i)
+                _array[destination++] = dacal::move(scratch[cursor1++]);
+            size1 -= wins1;
+            if (size1 <= 1)
+                return;
+
+            _array[destination++] = dacal::move(_array[cursor2++]);
+            if (--size2 == 0)
+                return;
+
+            wins2 = gallop_left(
+                scratch[cursor1], _array, cursor2, size2, 0, _compare);
+            for (std::size_t i = 0; i < wins2; ++i)
+                _array[destination++] = dacal::move(_array[cursor2++]);
+            size2 -= wins2;
+            if (size2 == 0)
+                return;
+
+            _array[destination++] = dacal::move(scratch[cursor1++]);
+            if (--size1 == 1)
+                return;
+
+            if (_min_gallop > 0)
+                --_min_gallop;
+        } while (wins1 >= tim_sort_min_gallop || wins2 >= tim_sort_min_gallop);
+
+        // galloping stopped paying, make it harder to get back into
+        _min_gallop += 2;
+    }
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_merge_high(
+    std::size_t base1,
+    std::size_t size1,
+    std::size_t base2,
+    std::size_t size2)
+{
+    // the second run moves out and is merged back from the right; with the
+    // cursors kept as sizes the last element of the first run is at
+    // base1 + size1 - 1 and the next slot to fill at base1 + size1 + size2 - 1
+    auto scratch = _scratch(size2);
+    for (std::size_t i = 0; i < size2; ++i)
+        ::new (static_cast<void *>(scratch + i))
+            value_type(dacal::move(_array[base2 + i]));
+    auto copied = size2;
+
+    _array[base1 + size1 + size2 - 1] = dacal::move(_array[base1 + size1 - 1]);
+    if (--size1 != 0 && size2 > 1)
+        _gallop_high(scratch, base1, size1, size2);
+
+    if (size2 == 1) {
+        for (auto i = size1; i-- > 0;)
+            _array[base1 + i + 1] = dacal::move(_array[base1 + i]);
+        _array[base1] = dacal::move(scratch[0]);
+    }
+    else {
+        for (std::size_t i = 0; i < size2; ++i)
+            _array[base1 + size1 + i] = dacal::move(scratch[i]);
+    }
+    _release(scratch, copied);
+}
+
+template<class Iterator, class Buffer, class Compare>
+void tim_sort_state<Iterator, Buffer, Compare>::_gallop_high(
+    value_type *scratch,
+    std::size_t base1,
+    std::size_t &size1,
+    std::size_t &size2)
+{
+    // returns with size1 == 0 or size2 == 1, or size2 == 0 for a comparison
+    // that is not a strict weak order
+    for (;;) {
+        std::size_t wins1 = 0, wins2 = 0;
+
+        do {
+            auto destination = base1 + size1 + size2 - 1;
+            if (_compare(scratch[size2 - 1], _array[base1 + size1 - 1])) {
+                _array[destination] = dacal::move(_array[base1 + size1 - 1]);
+                ++wins1;
+                wins2 = 0;
+                if (--size1 == 0)
+                    return;
+            }
+            else {
+                _array[destination] = dacal::move(scratch[size2 - 1]);
+                ++wins2;
+                wins1 = 0;
+                if (--size2 == 1)
+                    return;
+            }
+        } while ((wins1 | wins2) < _min_gallop);
+
+        do {
+            wins1 = size1 -
+                gallop_right(scratch[size2 - 1],
+                             _array,
+                             base1,
+                             size1,
+                             size1 - 1,
+                             _compare);
+            for (std::size_t i = 0; i < wins1; ++i) {
+                _array[base1 + size1 + size2 - 1 - i] =
+                    dacal::move(_array[base1 + size1 - 1 - i]);
+            }
+            size1 -= wins1;
+            if (size1 == 0)
+                return;
+
+            _array[base1 + size1 + size2 - 1] =
+                dacal::move(scratch[size2 - 1]);
+            if (--size2 == 1)
+                return;
+
+            wins2 = size2 -
+                gallop_left(_array[base1 + size1 - 1],
+                            scratch,
+                            0,
+                            size2,
+                            size2 - 1,
+                            _compare);
+            for (std::size_t i = 0; i < wins2; ++i) {
+                _array[base1 + size1 + size2 - 1 - i] =
+                    dacal::move(scratch[size2 - 1 - i]);
+            }
+            size2 -= wins2;
+            if (size2 <= 1)
+                return;
+
+            _array[base1 + size1 + size2 - 1] =
+                dacal::move(_array[base1 + size1 - 1]);
+            if (--size1 == 0)
+                return;
+
+            if (_min_gallop > 0)
+                --_min_gallop;
+        } while (wins1 >= tim_sort_min_gallop || wins2 >= tim_sort_min_gallop);
+
+        _min_gallop += 2;
+    }
+}
+
+// natural merge sort: runs found in the input are extended to a minimum
+// length and merged with galloping, so sorted input costs n - 1 comparisons
+template<class Iterator, class Buffer, class Compare>
+void tim_sort(
+    Iterator array, std::size_t size, Buffer &buffer, const Compare &compare)
+{
+    tim_sort_state<Iterator, Buffer, Compare> state(array, buffer, compare);
+    state.sort(size);
+}
+
+}  // namespace detail
+
+#endif  // DACAL_TIM_SORT_HPP
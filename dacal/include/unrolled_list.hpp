@@ -0,0 +1,684 @@
+#ifndef DACAL_UNROLLED_LIST_HPP
+#define DACAL_UNROLLED_LIST_HPP
+
+#include "iterator.hpp"
+#include "memory_resource.hpp"
+#include "utils.hpp"
+
+#include <initializer_list>
+#include <memory>
+#include <new>
+
+namespace detail {
+template<class T, std::size_t Capacity>
+struct unrolled_list_node
+{
+    static_assert(Capacity >= 2, "a chunk must be able to hold two elements!");
+
+    [[maybe_unused]] T *_data()
+    {
+        return std::launder(reinterpret_cast<T *>(_storage)) + _begin;
+    }
+
+    // elements live in slots [_begin, _begin + _count) of the chunk, free
+    // slots on both sides give O(1) pushes at either end
+    unrolled_list_node *_predecessor{};
+    unrolled_list_node *_successor{};
+    std::size_t _begin{};
+    std::size_t _count{};
+    alignas(T) unsigned char _storage[Capacity * sizeof(T)];
+};
+
+template<class T, std::size_t Capacity>
+struct [[maybe_unused]] unrolled_list_iterator
+    : dacal::base_iterator<
+          dacal::bidirectional_iterator_tag,
+          T,
+          std::size_t,
+          T *,
+          T &>
+{
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::iterator_category;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::value_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::difference_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::pointer;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::reference;
+
+    [[maybe_unused]] explicit unrolled_list_iterator(
+        unrolled_list_node<T, Capacity> *ptr, std::size_t index = 0) :
+        _ptr(ptr),
+        _index(index)
+    {}
+    [[maybe_unused]] unrolled_list_iterator() = default;
+
+    [[maybe_unused]] unrolled_list_iterator &operator--()
+    {
+        if (_index > 0) {
+            --_index;
+        }
+        else {
+            _ptr = _ptr->_predecessor;
+            _index = _ptr ? _ptr->_count - 1 : 0;
+        }
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator--(int) -> unrolled_list_iterator
+    {
+        auto _temp = *this;
+        --(*this);
+        return _temp;
+    }
+
+    [[maybe_unused]] unrolled_list_iterator &operator++()
+    {
+        if (++_index == _ptr->_count) {
+            _ptr = _ptr->_successor;
+            _index = 0;
+        }
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator++(int) -> unrolled_list_iterator
+    {
+        auto _temp = *this;
+        ++(*this);
+        return _temp;
+    }
+
+    [[maybe_unused]] bool operator!=(const unrolled_list_iterator &i)
+    {
+        return this->_ptr != i._ptr || this->_index != i._index;
+    }
+
+    [[maybe_unused]] reference operator*()
+    {
+        return _ptr->_data()[_index];
+    }
+
+    unrolled_list_node<T, Capacity> *_ptr{};
+    std::size_t _index{};
+};
+
+template<class T, std::size_t Capacity>
+struct [[maybe_unused]] const_unrolled_list_iterator
+    : dacal::base_iterator<
+          dacal::bidirectional_iterator_tag,
+          T,
+          std::size_t,
+          T *,
+          T &>
+{
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::iterator_category;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::value_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::difference_type;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::pointer;
+
+    using typename dacal::base_iterator<
+        dacal::bidirectional_iterator_tag,
+        T,
+        std::size_t,
+        T *,
+        T &>::reference;
+
+    [[maybe_unused]] explicit const_unrolled_list_iterator(
+        unrolled_list_node<T, Capacity> *ptr, std::size_t index = 0) :
+        _ptr(ptr),
+        _index(index)
+    {}
+    [[maybe_unused]] const_unrolled_list_iterator() = default;
+
+    [[maybe_unused]] const_unrolled_list_iterator &operator--()
+    {
+        if (_index > 0) {
+            --_index;
+        }
+        else {
+            _ptr = _ptr->_predecessor;
+            _index = _ptr ? _ptr->_count - 1 : 0;
+        }
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator--(int) -> const_unrolled_list_iterator
+    {
+        auto _temp = *this;
+        --(*this);
+        return _temp;
+    }
+
+    [[maybe_unused]] const_unrolled_list_iterator &operator++()
+    {
+        if (++_index == _ptr->_count) {
+            _ptr = _ptr->_successor;
+            _index = 0;
+        }
+        return *this;
+    }
+
+    [[maybe_unused]] auto operator++(int) -> const_unrolled_list_iterator
+    {
+        auto _temp = *this;
+        ++(*this);
+        return _temp;
+    }
+
+    [[maybe_unused]] bool operator!=(const const_unrolled_list_iterator &i)
+    {
+        return this->_ptr != i._ptr || this->_index != i._index;
+    }
+
+    [[maybe_unused]] value_type operator*() const
+    {
+        return _ptr->_data()[_index];
+    }
+
+    unrolled_list_node<T, Capacity> *_ptr{};
+    std::size_t _index{};
+};
+
+}  // namespace detail
+
+namespace dacal {
+/*
+ *  Doubly linked list of fixed size chunks. ChunkBytes is the element
+ *  storage of one chunk; traversal touches one node per chunk instead of
+ *  one node per element.
+ **/
+template<
+    class T,
+    std::size_t ChunkBytes = 512,
+    class Allocator = std::allocator<T>>
+class [[maybe_unused]] unrolled_list
+{
+public:
+    static constexpr std::size_t chunk_capacity =
+        ChunkBytes / sizeof(T) > 2 ? ChunkBytes / sizeof(T) : 2;
+
+    using value_type = T;
+    using const_reference = const T &;
+    using node = detail::unrolled_list_node<T, chunk_capacity>;
+    using iterator = detail::unrolled_list_iterator<T, chunk_capacity>;
+    using const_iterator =
+        detail::const_unrolled_list_iterator<T, chunk_capacity>;
+    using reverse_iterator = detail::container_reverse_iterator<iterator>;
+    using allocator = Allocator;
+    using node_allocator = typename std::allocator_traits<
+        allocator>::template rebind_alloc<node>;
+
+    [[maybe_unused]] unrolled_list() = default;
+    [[maybe_unused]] explicit unrolled_list(const allocator &_alloc);
+    [[maybe_unused]] unrolled_list(const unrolled_list &_other);
+    [[maybe_unused]] unrolled_list(unrolled_list &&_other) noexcept;
+    [[maybe_unused]] unrolled_list(const std::initializer_list<T> &initializer);
+    [[maybe_unused]] ~unrolled_list();
+
+    [[maybe_unused]] unrolled_list &operator=(const unrolled_list &_other);
+    [[maybe_unused]] unrolled_list &operator=(unrolled_list &&_other) noexcept;
+
+    [[maybe_unused]] iterator begin() const;
+    [[maybe_unused]] iterator end() const;
+
+    [[maybe_unused]] const_iterator cbegin() const;
+    [[maybe_unused]] const_iterator cend() const;
+
+    [[maybe_unused]] reverse_iterator rbegin();
+    [[maybe_unused]] reverse_iterator rend();
+
+    [[maybe_unused]] void push_back(const_reference _data);
+    [[maybe_unused]] void push_front(const_reference _data);
+    [[maybe_unused]] iterator insert(iterator _pos, const_reference _data);
+    [[maybe_unused]] iterator erase(iterator _pos);
+    [[maybe_unused]] [[nodiscard]] value_type pop_back();
+    [[maybe_unused]] [[nodiscard]] value_type pop_front();
+
+    [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] bool empty() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+
+private:
+    [[maybe_unused]] node *_create_node(node *predecessor, std::size_t begin);
+    [[maybe_unused]] void _destroy_node(node *chunk);
+    [[maybe_unused]] void _split(node *chunk);
+    [[maybe_unused]] void _relocate(T *from, T *to);
+    [[maybe_unused]] void _destroy();
+
+    allocator _allocator;
+    node_allocator _node_allocator;
+    node *_list_head{}, *_list_tail{};
+    std::size_t _size{};
+};
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] typename unrolled_list<T, ChunkBytes, Allocator>::node *
+unrolled_list<T, ChunkBytes, Allocator>::_create_node(
+    node *predecessor, std::size_t begin)
+{
+    // links the new chunk after `predecessor`, or at the front when null
+    auto chunk =
+        std::allocator_traits<node_allocator>::allocate(_node_allocator, 1);
+    ::new (static_cast<void *>(chunk)) node;
+    chunk->_begin = begin;
+    chunk->_predecessor = predecessor;
+    chunk->_successor = predecessor ? predecessor->_successor : _list_head;
+
+    if (chunk->_successor)
+        chunk->_successor->_predecessor = chunk;
+    else
+        _list_tail = chunk;
+
+    if (predecessor)
+        predecessor->_successor = chunk;
+    else
+        _list_head = chunk;
+
+    return chunk;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void
+unrolled_list<T, ChunkBytes, Allocator>::_destroy_node(node *chunk)
+{
+    if (chunk->_predecessor)
+        chunk->_predecessor->_successor = chunk->_successor;
+    else
+        _list_head = chunk->_successor;
+
+    if (chunk->_successor)
+        chunk->_successor->_predecessor = chunk->_predecessor;
+    else
+        _list_tail = chunk->_predecessor;
+
+    chunk->~node();
+    std::allocator_traits<node_allocator>::deallocate(
+        _node_allocator, chunk, 1);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void unrolled_list<T, ChunkBytes, Allocator>::_relocate(
+    T *from, T *to)
+{
+    std::allocator_traits<allocator>::construct(
+        _allocator, to, dacal::move(*from));
+    std::allocator_traits<allocator>::destroy(_allocator, from);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void unrolled_list<T, ChunkBytes, Allocator>::_split(
+    node *chunk)
+{
+    // moves the upper half of a full chunk into a new chunk after it
+    auto half = chunk->_count / 2;
+    auto upper = _create_node(chunk, 0);
+    auto data = chunk->_data();
+    auto target = upper->_data();
+
+    for (std::size_t i = half; i < chunk->_count; ++i) {
+        _relocate(data + i, target + (i - half));
+    }
+    upper->_count = chunk->_count - half;
+    chunk->_count = half;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void unrolled_list<T, ChunkBytes, Allocator>::_destroy()
+{
+    while (_list_head) {
+        auto data = _list_head->_data();
+        for (std::size_t i = 0; i < _list_head->_count; ++i) {
+            std::allocator_traits<allocator>::destroy(_allocator, data + i);
+        }
+        _destroy_node(_list_head);
+    }
+    _size = 0;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator>::unrolled_list(
+    const allocator &_alloc) :
+    _allocator(_alloc),
+    _node_allocator(_alloc)
+{}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator>::unrolled_list(
+    const unrolled_list &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator)),
+    _node_allocator(_allocator)
+{
+    for (auto i = _other.begin(); i != _other.end(); ++i) {
+        push_back(*i);
+    }
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator>::unrolled_list(
+    unrolled_list &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator)),
+    _node_allocator(dacal::move(_other._node_allocator))
+{
+    _list_head = dacal::exchange(_other._list_head, nullptr);
+    _list_tail = dacal::exchange(_other._list_tail, nullptr);
+    _size = dacal::exchange(_other._size, 0);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator>::unrolled_list(
+    const std::initializer_list<T> &initializer)
+{
+    for (auto i = initializer.begin(); i != initializer.end(); ++i) {
+        push_back(*i);
+    }
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator>::~unrolled_list()
+{
+    _destroy();
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator> &
+unrolled_list<T, ChunkBytes, Allocator>::operator=(const unrolled_list &_other)
+{
+    if (this != &_other) {
+        _destroy();
+        for (auto i = _other.begin(); i != _other.end(); ++i) {
+            push_back(*i);
+        }
+    }
+    return *this;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] unrolled_list<T, ChunkBytes, Allocator> &
+unrolled_list<T, ChunkBytes, Allocator>::operator=(
+    unrolled_list &&_other) noexcept
+{
+    if (this != &_other) {
+        _destroy();
+
+        // the chunks can only be released by the allocator that made them
+        _allocator = _other._allocator;
+        _node_allocator = _other._node_allocator;
+        _list_head = dacal::exchange(_other._list_head, nullptr);
+        _list_tail = dacal::exchange(_other._list_tail, nullptr);
+        _size = dacal::exchange(_other._size, 0);
+    }
+    return *this;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] typename unrolled_list<T, ChunkBytes, Allocator>::iterator
+unrolled_list<T, ChunkBytes, Allocator>::begin() const
+{
+    return iterator(_list_head);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] typename unrolled_list<T, ChunkBytes, Allocator>::iterator
+unrolled_list<T, ChunkBytes, Allocator>::end() const
+{
+    return iterator(nullptr);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]]
+typename unrolled_list<T, ChunkBytes, Allocator>::const_iterator
+unrolled_list<T, ChunkBytes, Allocator>::cbegin() const
+{
+    return const_iterator(_list_head);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]]
+typename unrolled_list<T, ChunkBytes, Allocator>::const_iterator
+unrolled_list<T, ChunkBytes, Allocator>::cend() const
+{
+    return const_iterator(nullptr);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]]
+typename unrolled_list<T, ChunkBytes, Allocator>::reverse_iterator
+unrolled_list<T, ChunkBytes, Allocator>::rbegin()
+{
+    return reverse_iterator(
+        iterator(_list_tail, _list_tail ? _list_tail->_count - 1 : 0));
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]]
+typename unrolled_list<T, ChunkBytes, Allocator>::reverse_iterator
+unrolled_list<T, ChunkBytes, Allocator>::rend()
+{
+    return reverse_iterator(iterator(nullptr));
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void
+unrolled_list<T, ChunkBytes, Allocator>::push_back(const_reference _data)
+{
+    auto chunk = _list_tail;
+    if (chunk == nullptr || chunk->_begin + chunk->_count == chunk_capacity)
+        chunk = _create_node(_list_tail, 0);
+
+    std::allocator_traits<allocator>::construct(
+        _allocator, chunk->_data() + chunk->_count, _data);
+    ++chunk->_count;
+    ++_size;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] void
+unrolled_list<T, ChunkBytes, Allocator>::push_front(const_reference _data)
+{
+    auto chunk = _list_head;
+    if (chunk == nullptr || chunk->_begin == 0)
+        chunk = _create_node(nullptr, chunk_capacity);
+
+    --chunk->_begin;
+    std::allocator_traits<allocator>::construct(
+        _allocator, chunk->_data(), _data);
+    ++chunk->_count;
+    ++_size;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] typename unrolled_list<T, ChunkBytes, Allocator>::iterator
+unrolled_list<T, ChunkBytes, Allocator>::insert(
+    iterator _pos, const_reference _data)
+{
+    if (_pos._ptr == nullptr) {
+        push_back(_data);
+        return iterator(_list_tail, _list_tail->_count - 1);
+    }
+
+    auto chunk = _pos._ptr;
+    auto index = _pos._index;
+
+    if (chunk->_count == chunk_capacity) {
+        _split(chunk);
+        if (index > chunk->_count) {
+            index -= chunk->_count;
+            chunk = chunk->_successor;
+        }
+    }
+
+    if (chunk->_begin + chunk->_count < chunk_capacity) {
+        // open a gap by shifting the tail of the chunk to the right
+        auto data = chunk->_data();
+        for (auto i = chunk->_count; i > index; --i) {
+            _relocate(data + i - 1, data + i);
+        }
+    }
+    else {
+        // no room after the last element, shift the head to the left
+        --chunk->_begin;
+        auto data = chunk->_data();
+        for (std::size_t i = 0; i < index; ++i) {
+            _relocate(data + i + 1, data + i);
+        }
+    }
+
+    std::allocator_traits<allocator>::construct(
+        _allocator, chunk->_data() + index, _data);
+    ++chunk->_count;
+    ++_size;
+    return iterator(chunk, index);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] typename unrolled_list<T, ChunkBytes, Allocator>::iterator
+unrolled_list<T, ChunkBytes, Allocator>::erase(iterator _pos)
+{
+    auto chunk = _pos._ptr;
+    auto index = _pos._index;
+    auto data = chunk->_data();
+
+    std::allocator_traits<allocator>::destroy(_allocator, data + index);
+
+    // close the gap from whichever side moves fewer elements
+    if (index < chunk->_count - index - 1) {
+        for (auto i = index; i > 0; --i) {
+            _relocate(data + i - 1, data + i);
+        }
+        ++chunk->_begin;
+    }
+    else {
+        for (auto i = index + 1; i < chunk->_count; ++i) {
+            _relocate(data + i, data + i - 1);
+        }
+    }
+    --chunk->_count;
+    --_size;
+
+    if (chunk->_count == 0) {
+        auto successor = chunk->_successor;
+        _destroy_node(chunk);
+        return iterator(successor);
+    }
+    if (index == chunk->_count)
+        return iterator(chunk->_successor);
+    return iterator(chunk, index);
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] [[nodiscard]]
+typename unrolled_list<T, ChunkBytes, Allocator>::value_type
+unrolled_list<T, ChunkBytes, Allocator>::pop_back()
+{
+    auto chunk = _list_tail;
+    auto last = chunk->_data() + (chunk->_count - 1);
+    auto ret_val = dacal::move(*last);
+
+    std::allocator_traits<allocator>::destroy(_allocator, last);
+    if (--chunk->_count == 0)
+        _destroy_node(chunk);
+    --_size;
+    return ret_val;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] [[nodiscard]]
+typename unrolled_list<T, ChunkBytes, Allocator>::value_type
+unrolled_list<T, ChunkBytes, Allocator>::pop_front()
+{
+    auto chunk = _list_head;
+    auto first = chunk->_data();
+    auto ret_val = dacal::move(*first);
+
+    std::allocator_traits<allocator>::destroy(_allocator, first);
+    ++chunk->_begin;
+    if (--chunk->_count == 0)
+        _destroy_node(chunk);
+    --_size;
+    return ret_val;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] [[nodiscard]] std::size_t
+unrolled_list<T, ChunkBytes, Allocator>::size() const
+{
+    return _size;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] [[nodiscard]] bool
+unrolled_list<T, ChunkBytes, Allocator>::empty() const
+{
+    return _size == 0;
+}
+
+template<class T, std::size_t ChunkBytes, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename unrolled_list<
+    T, ChunkBytes, Allocator>::allocator
+unrolled_list<T, ChunkBytes, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+namespace pmr {
+template<class T, std::size_t ChunkBytes = 512>
+using unrolled_list =
+    dacal::unrolled_list<T, ChunkBytes, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
+}  // namespace dacal
+
+#endif  // DACAL_UNROLLED_LIST_HPP
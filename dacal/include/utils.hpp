@@ -1,8 +1,32 @@
 #ifndef DACAL_UTILITY_HPP
 #define DACAL_UTILITY_HPP
 
+#include <cstddef>
 #include <cstdint>
 
+namespace detail {
+[[maybe_unused]] constexpr uint64_t hash_mix(uint64_t _value) noexcept
+{
+    // splitmix64 finalizer
+    _value ^= _value >> 30;
+    _value *= 0xbf58476d1ce4e5b9ULL;
+    _value ^= _value >> 27;
+    _value *= 0x94d049bb133111ebULL;
+    _value ^= _value >> 31;
+    return _value;
+}
+
+template<class T>
+struct integral_hash
+{
+    uint64_t operator()(const T &_val) const noexcept
+    {
+        return hash_mix(static_cast<uint64_t>(_val));
+    }
+};
+
+}  // namespace detail
+
 namespace dacal {
 template<class T>
 struct remove_reference
@@ -32,9 +56,9 @@ move(T &&_arg) noexcept
 template<class T>
 [[maybe_unused]] void swap(T &_object_A, T &_object_B) noexcept
 {
-    auto _temp = move(_object_A);
-    _object_A = move(_object_B);
-    _object_B = move(_temp);
+    auto _temp = dacal::move(_object_A);
+    _object_A = dacal::move(_object_B);
+    _object_B = dacal::move(_temp);
 }
 
 template<class T, class U = T>
@@ -108,6 +132,24 @@ struct [[maybe_unused]] modulus
     }
 };
 
+template<class T>
+struct [[maybe_unused]] minimum
+{
+    [[maybe_unused]] T operator()(const T &_lhs, const T &_rhs) const
+    {
+        return _rhs < _lhs ? _rhs : _lhs;
+    }
+};
+
+template<class T>
+struct [[maybe_unused]] maximum
+{
+    [[maybe_unused]] T operator()(const T &_lhs, const T &_rhs) const
+    {
+        return _lhs < _rhs ? _rhs : _lhs;
+    }
+};
+
 template<class T>
 struct [[maybe_unused]] negate
 {
@@ -122,13 +164,30 @@ struct hash
 {};
 
 template<>
-struct [[maybe_unused]] hash<int>
-{
-    uint64_t operator()(const int &_val) const noexcept
-    {
-        return ((_val | 0b111001010011010) << 12) % 10;
-    }
-};
+struct [[maybe_unused]] hash<int> : detail::integral_hash<int>
+{};
+
+template<>
+struct [[maybe_unused]] hash<unsigned int> : detail::integral_hash<unsigned int>
+{};
+
+template<>
+struct [[maybe_unused]] hash<long> : detail::integral_hash<long>
+{};
+
+template<>
+struct [[maybe_unused]] hash<unsigned long>
+    : detail::integral_hash<unsigned long>
+{};
+
+template<>
+struct [[maybe_unused]] hash<long long> : detail::integral_hash<long long>
+{};
+
+template<>
+struct [[maybe_unused]] hash<unsigned long long>
+    : detail::integral_hash<unsigned long long>
+{};
 
 template<>
 struct [[maybe_unused]] hash<const char *>
@@ -153,6 +212,22 @@ struct [[maybe_unused]] hash<T *>
     }
 };
 
+/*
+ *  Bytes a container holds: element payload, and everything else it pays
+ *  for that (links, unused capacity, the container object itself). Block
+ *  headers kept by the allocator are not visible here.
+ **/
+struct [[maybe_unused]] memory_footprint
+{
+    [[maybe_unused]] [[nodiscard]] std::size_t total() const
+    {
+        return _payload + _overhead;
+    }
+
+    std::size_t _payload{};
+    std::size_t _overhead{};
+};
+
 }  // namespace dacal
 
 // red-black tree utils
@@ -179,12 +254,6 @@ struct rb_tree_node
         _parent(parent)
     {}
 
-    [[maybe_unused]] ~rb_tree_node()
-    {
-        delete _left_child;
-        delete _right_child;
-    }
-
     [[maybe_unused]] static rb_tree_node<T> *
     _leftmost_node(rb_tree_node<T> *_node)
     {
@@ -2,50 +2,61 @@
 #define DACAL_VECTOR_HPP
 
 #include "iterator.hpp"
+#include "memory_resource.hpp"
 #include "utils.hpp"
 
+#include <concepts>
+#include <cstring>
 #include <initializer_list>
 #include <memory>
+#include <type_traits>
 
 namespace detail {
+// allocators that can grow a block without a copy, see hugepage_allocator
+template<class Allocator, class T>
+concept reallocating_allocator =
+    requires(Allocator allocator, T *ptr, std::size_t n) {
+        { allocator.reallocate(ptr, n, n) } -> std::same_as<T *>;
+    };
+
 template<class T>
 struct [[maybe_unused]] vector_iterator : dacal::base_iterator<
-                                              dacal::random_access_iterator_tag,
+                                              dacal::contiguous_iterator_tag,
                                               T,
                                               std::size_t,
                                               T *,
                                               T &>
 {
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::iterator_category;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::value_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::difference_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::pointer;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
@@ -135,42 +146,42 @@ struct [[maybe_unused]] vector_iterator : dacal::base_iterator<
 template<class T>
 struct [[maybe_unused]] const_vector_iterator
     : dacal::base_iterator<
-          dacal::random_access_iterator_tag,
+          dacal::contiguous_iterator_tag,
           T,
           std::size_t,
           T *,
           T &>
 {
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::iterator_category;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::value_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::difference_type;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
         T &>::pointer;
 
     using typename dacal::base_iterator<
-        dacal::random_access_iterator_tag,
+        dacal::contiguous_iterator_tag,
         T,
         std::size_t,
         T *,
@@ -268,6 +279,7 @@ public:
     using allocator = Allocator;
 
     [[maybe_unused]] vector();
+    [[maybe_unused]] explicit vector(const allocator &_alloc);
     [[maybe_unused]] vector(const std::initializer_list<T> &_initializer);
     [[maybe_unused]] vector(const vector &_other);
     [[maybe_unused]] vector(vector &&_other) noexcept;
@@ -291,6 +303,8 @@ public:
     [[maybe_unused]] [[nodiscard]] value_type pop_back();
     [[maybe_unused]] [[nodiscard]] value_type pop_front();
     [[maybe_unused]] [[nodiscard]] std::size_t size() const;
+    [[maybe_unused]] [[nodiscard]] allocator get_allocator() const;
+    [[maybe_unused]] [[nodiscard]] memory_footprint memory_usage() const;
 
 private:
     [[maybe_unused]] void _realloc(std::size_t _new_capacity);
@@ -304,15 +318,35 @@ private:
 template<class T, class Allocator>
 [[maybe_unused]] void vector<T, Allocator>::_realloc(std::size_t _new_capacity)
 {
+    if constexpr (
+        detail::reallocating_allocator<allocator, T> &&
+        std::is_trivially_copyable_v<T>) {
+        if (_data != nullptr) {
+            auto _moved =
+                _allocator.reallocate(_data, _capacity, _new_capacity);
+            if (_moved != nullptr) {
+                _data = _moved;
+                _capacity = _new_capacity;
+                return;
+            }
+        }
+    }
+
     auto _tmp_buffer =
         std::allocator_traits<allocator>::allocate(_allocator, _new_capacity);
 
-    for (auto i = 0; i < _size; ++i) {
-        _tmp_buffer[i] = dacal::move(_data[i]);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_size != 0)
+            std::memcpy(_tmp_buffer, _data, _size * sizeof(T));
+    }
+    else {
+        for (auto i = 0; i < _size; ++i) {
+            _tmp_buffer[i] = dacal::move(_data[i]);
+        }
     }
 
     std::allocator_traits<allocator>::destroy(_allocator, _data);
-    std::allocator_traits<allocator>::deallocate(_allocator, _data, _size);
+    std::allocator_traits<allocator>::deallocate(_allocator, _data, _capacity);
     _data = _tmp_buffer;
     _capacity = _new_capacity;
 }
@@ -323,6 +357,13 @@ template<class T, class Allocator>
     _realloc(2);
 }
 
+template<class T, class Allocator>
+[[maybe_unused]] vector<T, Allocator>::vector(const allocator &_alloc) :
+    _allocator(_alloc)
+{
+    _realloc(2);
+}
+
 template<class T, class Allocator>
 [[maybe_unused]] vector<T, Allocator>::vector(
     const std::initializer_list<T> &_initializer)
@@ -333,18 +374,30 @@ template<class T, class Allocator>
 }
 
 template<class T, class Allocator>
-[[maybe_unused]] vector<T, Allocator>::vector(const vector &_other)
+[[maybe_unused]] vector<T, Allocator>::vector(const vector &_other) :
+    _allocator(std::allocator_traits<
+               allocator>::select_on_container_copy_construction(
+        _other._allocator))
 {
     this->_data = std::allocator_traits<allocator>::allocate(
         _allocator, _other._capacity);
+    _capacity = _other._capacity;
 
-    for (auto i = 0; i < _other._size; ++i) {
-        _data[_size++] = _other._data[i];
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_other._size != 0)
+            std::memcpy(_data, _other._data, _other._size * sizeof(T));
+        _size = _other._size;
+    }
+    else {
+        for (auto i = 0; i < _other._size; ++i) {
+            _data[_size++] = _other._data[i];
+        }
     }
 }
 
 template<class T, class Allocator>
-[[maybe_unused]] vector<T, Allocator>::vector(vector &&_other) noexcept
+[[maybe_unused]] vector<T, Allocator>::vector(vector &&_other) noexcept :
+    _allocator(dacal::move(_other._allocator))
 {
     _capacity = dacal::exchange(_other._capacity, 0);
     _size = dacal::exchange(_other._size, 0);
@@ -363,11 +416,24 @@ template<class T, class Allocator>
 vector<T, Allocator>::operator=(const vector &_other)
 {
     if (this != &_other) {
+        std::allocator_traits<allocator>::destroy(_allocator, _data);
+        std::allocator_traits<allocator>::deallocate(
+            _allocator, _data, _capacity);
+
         this->_data = std::allocator_traits<allocator>::allocate(
             _allocator, _other._capacity);
+        _capacity = _other._capacity;
+        _size = 0;
 
-        for (auto i = 0; i < _other._size; ++i) {
-            _data[_size++] = _other._data[i];
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (_other._size != 0)
+                std::memcpy(_data, _other._data, _other._size * sizeof(T));
+            _size = _other._size;
+        }
+        else {
+            for (auto i = 0; i < _other._size; ++i) {
+                _data[_size++] = _other._data[i];
+            }
         }
     }
     return *this;
@@ -377,9 +443,17 @@ template<class T, class Allocator>
 [[maybe_unused]] vector<T, Allocator> &
 vector<T, Allocator>::operator=(vector &&_other) noexcept
 {
-    _capacity = dacal::exchange(_other._capacity, 0);
-    _size = dacal::exchange(_other._size, 0);
-    _data = dacal::exchange(_other._data, nullptr);
+    if (this != &_other) {
+        std::allocator_traits<allocator>::destroy(_allocator, _data);
+        std::allocator_traits<allocator>::deallocate(
+            _allocator, _data, _capacity);
+
+        // the buffer can only be released by the allocator that made it
+        _allocator = _other._allocator;
+        _capacity = dacal::exchange(_other._capacity, 0);
+        _size = dacal::exchange(_other._size, 0);
+        _data = dacal::exchange(_other._data, nullptr);
+    }
     return *this;
 }
 
@@ -481,6 +555,27 @@ template<class T, class Allocator>
     return _size;
 }
 
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] typename vector<T, Allocator>::allocator
+vector<T, Allocator>::get_allocator() const
+{
+    return _allocator;
+}
+
+template<class T, class Allocator>
+[[maybe_unused]] [[nodiscard]] memory_footprint
+vector<T, Allocator>::memory_usage() const
+{
+    auto _reserved = _data != nullptr ? _capacity : 0;
+    return {_size * sizeof(T), (_reserved - _size) * sizeof(T) + sizeof(*this)};
+}
+
+namespace pmr {
+template<class T>
+using vector = dacal::vector<T, polymorphic_allocator<T>>;
+
+}  // namespace pmr
+
 }  // namespace dacal
 
 #endif  // DACAL_VECTOR_HPP